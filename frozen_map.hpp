@@ -0,0 +1,286 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   frozen_map.hpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mstrantz <mstrantz@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 19:10:37 by mstrantz          #+#    #+#             */
+/*   Updated: 2026/10/18 19:10:37 by mstrantz         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef FROZEN_MAP_HPP
+# define FROZEN_MAP_HPP
+
+// Frozen map
+//  A read-only copy of an ft::map for maps that are built once and then only
+//  searched. The keys are packed into one array in Eytzinger order (the layout
+//  of a binary heap: the children of slot i are 2i and 2i + 1) and the mapped
+//  values into a second array in the same order.
+//
+//  A search walks down the array with a single comparison per level and no
+//  branch on its result, and the first levels of the tree share a few cache
+//  lines. There are no node pointers, colors or allocator headers, so a
+//  map<int, int> takes 8 bytes per element instead of 40.
+
+# include <functional>
+# include <memory>
+# include <stdexcept>
+# include "utils/Pair.hpp"
+# include "iterators/eytzinger_iterator.hpp"
+# include "map.hpp"
+
+namespace ft {
+
+template<class Key,
+         class T,
+         class Compare = std::less<const Key>,
+         class Alloc = std::allocator<ft::pair<const Key, T> >
+        >
+        class frozen_map {
+
+            public:
+                typedef Key                                                         key_type;
+                typedef T                                                           mapped_type;
+                typedef ft::pair<const key_type, mapped_type>                       value_type;
+                typedef Compare                                                     key_compare;
+                typedef Alloc                                                       allocator_type;
+                typedef typename allocator_type::size_type                          size_type;
+                typedef ft::eytzinger_iterator<key_type, mapped_type>               const_iterator;
+                typedef const_iterator                                              iterator;
+                typedef typename const_iterator::reference                          reference;
+                typedef typename const_iterator::reference                          const_reference;
+                typedef typename const_iterator::difference_type                    difference_type;
+
+            private:
+                typedef typename allocator_type::template rebind<key_type>::other       key_allocator_type;
+                typedef typename allocator_type::template rebind<mapped_type>::other    mapped_allocator_type;
+
+                // keys per cache line, the descendants of slot i four levels
+                // down are the 16 consecutive slots from 16i
+                static const size_type  _prefetch_stride = 16;
+
+                key_compare             _comp;
+                key_allocator_type      _key_alloc;
+                mapped_allocator_type   _mapped_alloc;
+                key_type                *_keys;
+                mapped_type             *_values;
+                size_type               _size;
+
+                // first slot in key order
+                size_type   _first() const {
+                    if (_size == 0)
+                        return (0);
+                    size_type   i = 1;
+                    while (2 * i <= _size)
+                        i = 2 * i;
+                    return (i);
+                }
+
+                void    _prefetch(size_type i) const {
+# if defined(__GNUC__) || defined(__clang__)
+                    if (_prefetch_stride * i <= _size)
+                        __builtin_prefetch(_keys + _prefetch_stride * i);
+# else
+                    (void)i;
+# endif
+                }
+
+                // Goes down to a leaf, right when less(slot, key) holds. The
+                // bound is the last slot we went left at: dropping the trailing
+                // right turns and the left turn before them gives its index.
+                // 0 means there is none.
+                template <class Less>
+                size_type   _bound(Less less) const {
+                    size_type   i = 1;
+                    while (i <= _size) {
+                        _prefetch(i);
+                        i = 2 * i + less(_keys[i]);
+                    }
+                    while (i & 1)
+                        i >>= 1;
+                    return (i >> 1);
+                }
+
+                struct _slot_less {
+                    key_compare const   &comp;
+                    key_type const      &key;
+                    _slot_less(key_compare const &c, key_type const &k) : comp(c), key(k) { }
+                    bool    operator()(key_type const &slot) const { return (comp(slot, key)); }
+                };
+
+                struct _slot_not_greater {
+                    key_compare const   &comp;
+                    key_type const      &key;
+                    _slot_not_greater(key_compare const &c, key_type const &k) : comp(c), key(k) { }
+                    bool    operator()(key_type const &slot) const { return (!comp(key, slot)); }
+                };
+
+                const_iterator  _at(size_type i) const {
+                    return (const_iterator(_keys, _values, _size, i));
+                }
+
+                void    _allocate(size_type n) {
+                    _size = n;
+                    _keys = (n > 0 ? _key_alloc.allocate(n + 1) : NULL);
+                    _values = (n > 0 ? _mapped_alloc.allocate(n + 1) : NULL);
+                }
+
+                // builds slot i, or nothing when the key or the value throws
+                void    _construct(size_type i, key_type const &key, mapped_type const &value) {
+                    _key_alloc.construct(_keys + i, key);
+                    try {
+                        _mapped_alloc.construct(_values + i, value);
+                    }
+                    catch (...) {
+                        _key_alloc.destroy(_keys + i);
+                        throw ;
+                    }
+                }
+
+                void    _destroy_slot(size_type i) {
+                    _key_alloc.destroy(_keys + i);
+                    _mapped_alloc.destroy(_values + i);
+                }
+
+                // the slots have to be destroyed already
+                void    _deallocate() {
+                    if (_size > 0) {
+                        _key_alloc.deallocate(_keys, _size + 1);
+                        _mapped_alloc.deallocate(_values, _size + 1);
+                    }
+                    _keys = NULL;
+                    _values = NULL;
+                    _size = 0;
+                }
+
+                void    _destroy() {
+                    for (size_type i = 1; i <= _size; ++i)
+                        _destroy_slot(i);
+                    _deallocate();
+                }
+
+            public:
+                /* ------- Constructors ------- */
+                explicit frozen_map(const key_compare& comp = key_compare(),
+                                    const allocator_type& alloc = allocator_type())
+                    : _comp(comp), _key_alloc(alloc), _mapped_alloc(alloc), _keys(NULL), _values(NULL), _size(0) { }
+
+                // the elements of m are written in key order to the slots in
+                // the in-order of the implicit tree
+                template <class MapAlloc>
+                    explicit frozen_map(const ft::map<key_type, mapped_type, key_compare, MapAlloc>& m,
+                                        const allocator_type& alloc = allocator_type())
+                        : _comp(m.key_comp()), _key_alloc(alloc), _mapped_alloc(alloc), _keys(NULL), _values(NULL), _size(0) {
+                        _allocate(m.size());
+                        size_type   i = _first();
+                        size_type   built = 0;
+                        try {
+                            for (typename ft::map<key_type, mapped_type, key_compare, MapAlloc>::const_iterator it = m.begin();
+                                    it != m.end(); ++it, ++built) {
+                                _construct(i, it->first, it->second);
+                                i = (++_at(i)).base();
+                            }
+                        }
+                        catch (...) {
+                            for (i = _first(); built > 0; --built, i = (++_at(i)).base())
+                                _destroy_slot(i);
+                            _deallocate();
+                            throw ;
+                        }
+                    }
+
+                frozen_map(const frozen_map& x)
+                    : _comp(x._comp), _key_alloc(x._key_alloc), _mapped_alloc(x._mapped_alloc), _keys(NULL), _values(NULL), _size(0) {
+                    _allocate(x._size);
+                    size_type   i = 1;
+                    try {
+                        for (; i <= _size; ++i)
+                            _construct(i, x._keys[i], x._values[i]);
+                    }
+                    catch (...) {
+                        while (--i > 0)
+                            _destroy_slot(i);
+                        _deallocate();
+                        throw ;
+                    }
+                }
+
+                /* ------- Destructor ------- */
+                ~frozen_map() {
+                    _destroy();
+                }
+
+                /* ------- Assignment operator overload ------- */
+                frozen_map  &operator=(const frozen_map& x) {
+                    if (this == &x)
+                        return (*this);
+                    frozen_map  tmp(x);
+                    swap(tmp);
+                    return (*this);
+                }
+
+                /* ------- Iterators ------- */
+                const_iterator  begin() const   { return (_at(_first())); }
+                const_iterator  end() const     { return (_at(0)); }
+
+                /* ------- Capacity ------- */
+                bool        empty() const   { return (_size == 0); }
+                size_type   size() const    { return (_size); }
+
+                /* ------- Element Access ------- */
+                const mapped_type   &at(const key_type& k) const {
+                    const_iterator  it = find(k);
+                    if (it == end())
+                        throw std::out_of_range("frozen_map::at");
+                    return (_values[it.base()]);
+                }
+
+                /* ------- Modifiers ------- */
+                void    swap(frozen_map& x) {
+                    std::swap(_comp, x._comp);
+                    std::swap(_key_alloc, x._key_alloc);
+                    std::swap(_mapped_alloc, x._mapped_alloc);
+                    std::swap(_keys, x._keys);
+                    std::swap(_values, x._values);
+                    std::swap(_size, x._size);
+                }
+
+                /* ------- Observers ------- */
+                key_compare     key_comp() const        { return (_comp); }
+                allocator_type  get_allocator() const   { return (allocator_type(_key_alloc)); }
+
+                /* ------- Operations ------- */
+                const_iterator  lower_bound(const key_type& k) const {
+                    return (_at(_bound(_slot_less(_comp, k))));
+                }
+
+                const_iterator  upper_bound(const key_type& k) const {
+                    return (_at(_bound(_slot_not_greater(_comp, k))));
+                }
+
+                const_iterator  find(const key_type& k) const {
+                    size_type   i = _bound(_slot_less(_comp, k));
+                    if (i == 0 || _comp(k, _keys[i]))
+                        return (end());
+                    return (_at(i));
+                }
+
+                size_type   count(const key_type& k) const {
+                    return (find(k) != end());
+                }
+
+                ft::pair<const_iterator, const_iterator>    equal_range(const key_type& k) const {
+                    return (ft::make_pair(lower_bound(k), upper_bound(k)));
+                }
+        };
+
+template<class Key, class T, class Compare, class Alloc>
+    void    swap(frozen_map<Key, T, Compare, Alloc>& x, frozen_map<Key, T, Compare, Alloc>& y) {
+        x.swap(y);
+    }
+
+} // namespace ft
+
+#endif // FROZEN_MAP_HPP
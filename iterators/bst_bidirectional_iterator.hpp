@@ -15,6 +15,8 @@
 
 # include <cstddef>
 # include "iterator_traits.hpp"
+# include "../utils/TypeTraits.hpp"
+# include "../utils/TreeNode.hpp"
 
 namespace ft {
 
@@ -36,8 +38,13 @@ class bst_bidirectional_iterator {
 
         bst_bidirectional_iterator(void) : _curr() {}
         bst_bidirectional_iterator(Node const &in) : _curr(in) {}
-        bst_bidirectional_iterator(const bst_bidirectional_iterator<typename container::Node *, container, typename container::value_type> &rhs)\
-            : _curr(rhs.base()) {}
+        bst_bidirectional_iterator(bst_bidirectional_iterator const &rhs) : _curr(rhs._curr) {}
+        // iterator to const_iterator. As a template it is never taken for the
+        // copy constructor, which C++11 wants declared next to operator=
+        template <class It>
+            bst_bidirectional_iterator(It const &rhs, typename ft::enable_if<ft::is_same<It,
+                bst_bidirectional_iterator<typename container::Node *, container, typename container::value_type> >::value, int>::type = 0)
+                : _curr(rhs.base()) {}
         ~bst_bidirectional_iterator(void) {}
         
         Node    &base() { return _curr; }
@@ -58,13 +65,14 @@ class bst_bidirectional_iterator {
                     _curr = _curr->left;
             }
             else {
-                Node    p = _curr->parent;
-                while (p != NULL && _curr == p->right) {
+                Node    p = _curr->get_parent();
+                while (p != NULL && p->get_parent() != NULL && _curr == p->right) {
                     _curr = p;
-                    p = p->parent;
+                    p = p->get_parent();
                 }
                 _curr = p;
             }
+            tree_prefetch_next(_curr);
             return (*this);
         }
         
@@ -79,19 +87,24 @@ class bst_bidirectional_iterator {
                 }
             }
             else {
-                Node    p = _curr->parent;
-                while (p != NULL && _curr == p->right) {
+                Node    p = _curr->get_parent();
+                while (p != NULL && p->get_parent() != NULL && _curr == p->right) {
                     _curr = p;
-                    p = p->parent;
+                    p = p->get_parent();
                 }
                 _curr = p;
             }
+            tree_prefetch_next(_curr);
             return (cpy);
         }
 
         bst_bidirectional_iterator  &operator--() {
             if (_curr == NULL) {
             }
+            else if (_curr->get_parent() == NULL && _curr->right != NULL) {
+                // end(), the header keeps a link to the last node
+                _curr = _curr->right;
+            }
             else if (_curr->left != NULL) {
                 _curr = _curr->left;
                 while (_curr->right) {
@@ -99,13 +112,14 @@ class bst_bidirectional_iterator {
                 }
             }
             else {
-                Node    p = _curr->parent;
+                Node    p = _curr->get_parent();
                 while (p != NULL && _curr == p->left) {
                     _curr = p;
-                    p = p->parent;
+                    p = p->get_parent();
                 }
                 _curr = p;
             }
+            tree_prefetch_prev(_curr);
             return (*this);
         }
 
@@ -113,6 +127,10 @@ class bst_bidirectional_iterator {
             bst_bidirectional_iterator  cpy(_curr);
             if (_curr == NULL) {
             }
+            else if (_curr->get_parent() == NULL && _curr->right != NULL) {
+                // end(), the header keeps a link to the last node
+                _curr = _curr->right;
+            }
             else if (_curr->left != NULL) {
                 _curr = _curr->left;
                 while (_curr->right) {
@@ -120,30 +138,39 @@ class bst_bidirectional_iterator {
                 }
             }
             else {
-                Node    p = _curr->parent;
+                Node    p = _curr->get_parent();
                 while (p != NULL && _curr == p->left) {
                     _curr = p;
-                    p = p->parent;
+                    p = p->get_parent();
                 }
                 _curr = p;
             }
+            tree_prefetch_prev(_curr);
             return (cpy);
         }
 
         bst_bidirectional_iterator	operator-(int const &i) const {
+# ifdef FT_ORDER_STATISTICS
+            return (bst_bidirectional_iterator(tree_advance(_curr, -static_cast<long>(i))));
+# else
 		    bst_bidirectional_iterator ret = *this;
 		    for (int j = 0; j < i; j++) {
 		    	ret--;
 		    }
 		    return (ret);
+# endif
 	    }
 
 	    bst_bidirectional_iterator	operator+(int const &i) const {
+# ifdef FT_ORDER_STATISTICS
+            return (bst_bidirectional_iterator(tree_advance(_curr, static_cast<long>(i))));
+# else
 	    	bst_bidirectional_iterator ret = *this;
 	    	for (int j = 0; j < i; j++) {
 	    		ret++;
 	    	}
 	    	return (ret);
+# endif
 	    }
 
         bool    operator==(bst_bidirectional_iterator const &rhs) const {
@@ -171,6 +198,20 @@ class bst_bidirectional_iterator {
         }
 };
 
+# ifdef FT_ORDER_STATISTICS
+// O(log n) through the subtree sizes instead of counting every step
+template <typename T, typename container, typename value>
+    typename bst_bidirectional_iterator<T, container, value>::difference_type
+        distance(bst_bidirectional_iterator<T, container, value> first, bst_bidirectional_iterator<T, container, value> last) {
+            return (static_cast<ptrdiff_t>(tree_rank(last.base())) - static_cast<ptrdiff_t>(tree_rank(first.base())));
+        }
+
+template <typename T, typename container, typename value, class Distance>
+    void    advance(bst_bidirectional_iterator<T, container, value> &it, Distance n) {
+        it = bst_bidirectional_iterator<T, container, value>(tree_advance(it.base(), static_cast<long>(n)));
+    }
+# endif
+
 } // namespace ft
 
 #endif
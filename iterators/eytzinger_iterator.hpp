@@ -0,0 +1,132 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   eytzinger_iterator.hpp                             :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mstrantz <mstrantz@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 19:02:11 by mstrantz          #+#    #+#             */
+/*   Updated: 2026/10/18 19:02:11 by mstrantz         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef EYTZINGER_ITERATOR_HPP
+# define EYTZINGER_ITERATOR_HPP
+
+# include <cstddef>
+# include "iterator_traits.hpp"
+# include "../utils/Pair.hpp"
+
+namespace ft {
+
+// what the iterator yields: the key and the value as first and second, like
+// a pair of the map, which it converts to
+template <class Key, class T>
+struct eytzinger_reference {
+    Key const   &first;
+    T const     &second;
+
+    eytzinger_reference(Key const &k, T const &v) : first(k), second(v) { }
+
+    operator ft::pair<const Key, T>() const { return (ft::pair<const Key, T>(first, second)); }
+};
+
+// Walks the keys and values of a frozen_map in key order.
+//  The arrays are 1-based and in Eytzinger order: the children of slot i are
+//  the slots 2i and 2i + 1. Slot 0 is never used and stands for end().
+//  Keys and values live in separate arrays, so dereferencing yields a pair of
+//  references (eytzinger_reference) instead of a reference to a stored pair.
+template <class Key, class T>
+class eytzinger_iterator {
+
+    public:
+        typedef ptrdiff_t                               difference_type;
+        typedef ft::pair<const Key, T>                  value_type;
+        typedef ft::eytzinger_reference<Key, T>         reference;
+        typedef ft::bidirectional_iterator_tag          iterator_category;
+
+        // operator-> needs an object that outlives the call
+        class pointer {
+            reference   _ref;
+
+            public:
+                pointer(reference const &ref) : _ref(ref) { }
+                reference const *operator->() const { return (&_ref); }
+        };
+
+    private:
+        Key const   *_keys;
+        T const     *_values;
+        size_t      _size;
+        size_t      _i;
+
+    public:
+        eytzinger_iterator() : _keys(NULL), _values(NULL), _size(0), _i(0) { }
+        eytzinger_iterator(Key const *keys, T const *values, size_t size, size_t i)
+            : _keys(keys), _values(values), _size(size), _i(i) { }
+
+        size_t      base() const { return (_i); }
+
+        reference   operator*() const { return (reference(_keys[_i], _values[_i])); }
+        pointer     operator->() const { return (pointer(**this)); }
+
+        // the successor is the leftmost slot of the right subtree, or else the
+        // parent of the first ancestor that is a left child
+        eytzinger_iterator  &operator++() {
+            if (2 * _i + 1 <= _size) {
+                _i = 2 * _i + 1;
+                while (2 * _i <= _size)
+                    _i = 2 * _i;
+            }
+            else {
+                while (_i & 1)
+                    _i >>= 1;
+                _i >>= 1;
+            }
+            return (*this);
+        }
+
+        eytzinger_iterator  operator++(int) {
+            eytzinger_iterator  cpy(*this);
+            ++(*this);
+            return (cpy);
+        }
+
+        // end() steps back to the last slot
+        eytzinger_iterator  &operator--() {
+            if (_i == 0) {
+                _i = (_size > 0 ? 1 : 0);
+                while (2 * _i + 1 <= _size)
+                    _i = 2 * _i + 1;
+            }
+            else if (2 * _i <= _size) {
+                _i = 2 * _i;
+                while (2 * _i + 1 <= _size)
+                    _i = 2 * _i + 1;
+            }
+            else {
+                while (!(_i & 1))
+                    _i >>= 1;
+                _i >>= 1;
+            }
+            return (*this);
+        }
+
+        eytzinger_iterator  operator--(int) {
+            eytzinger_iterator  cpy(*this);
+            --(*this);
+            return (cpy);
+        }
+
+        bool    operator==(eytzinger_iterator const &rhs) const {
+            return (_i == rhs._i);
+        }
+
+        bool    operator!=(eytzinger_iterator const &rhs) const {
+            return !(*this == rhs);
+        }
+};
+
+} // namespace ft
+
+#endif // EYTZINGER_ITERATOR_HPP
@@ -14,6 +14,7 @@
 # define ITERATOR_TRAITS_HPP
 
 # include <cstddef>
+# include <iterator>
 
 namespace ft
 {
@@ -43,6 +44,26 @@ namespace ft
 				typedef ft::random_access_iterator_tag	iterator_category;
 		};
 
+	// maps the categories of std iterators onto the ft tags, so that
+	// helpers can dispatch on ranges coming from either library
+	template <class Category>
+		struct iterator_tag_of { typedef Category type; };
+
+	template <>
+		struct iterator_tag_of<std::input_iterator_tag> { typedef ft::input_iterator_tag type; };
+	template <>
+		struct iterator_tag_of<std::forward_iterator_tag> { typedef ft::forward_iterator_tag type; };
+	template <>
+		struct iterator_tag_of<std::bidirectional_iterator_tag> { typedef ft::bidirectional_iterator_tag type; };
+	template <>
+		struct iterator_tag_of<std::random_access_iterator_tag> { typedef ft::random_access_iterator_tag type; };
+
+	template <class Iterator>
+		typename iterator_tag_of<typename iterator_traits<Iterator>::iterator_category>::type
+			iterator_category(Iterator const &) {
+				return typename iterator_tag_of<typename iterator_traits<Iterator>::iterator_category>::type();
+			}
+
 	template <class Category, class T, class Distance = ptrdiff_t, \
 		class Pointer = T*, class Reference = T&>
 		struct iterator {
@@ -15,6 +15,7 @@
 
 # include <cstddef>
 # include "iterator_traits.hpp"
+# include "../utils/TypeTraits.hpp"
 
 namespace ft {
 
@@ -30,7 +31,11 @@ template <typename _value, typename vector>
 
 			random_access_iterator() : _ptr() {};
 			random_access_iterator(pointer ptr) : _ptr(ptr) {};
-			random_access_iterator(const random_access_iterator<typename vector::value_type, vector> &src) : _ptr(src.base()) {};
+			random_access_iterator(random_access_iterator const &src) : _ptr(src._ptr) {};
+			// iterator to const_iterator, a template so that it is never the copy constructor
+			template <class It>
+				random_access_iterator(It const &src, typename ft::enable_if<ft::is_same<It,
+					random_access_iterator<typename vector::value_type, vector> >::value, int>::type = 0) : _ptr(src.base()) {};
 
 			random_access_iterator	&operator=(random_access_iterator const &rhs) {
 				_ptr = rhs.base();
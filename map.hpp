@@ -17,14 +17,78 @@
 # include "utils/Pair.hpp"
 # include "utils/Algorithm.hpp"
 # include "iterators/bst_bidirectional_iterator.hpp"
+# include "utils/PoolAllocator.hpp"
 # include "utils/RedBlackTree.hpp"
 
 namespace ft {
 
+template<class Key, class T, class Compare, class Alloc>
+    class map;
+
+// orders the elements of a map by their keys
+template<class Key, class Value, class Compare>
+    class map_value_compare {
+        template<class K, class T, class C, class A>
+            friend class map;
+        friend struct three_way_compare<map_value_compare>;
+
+        protected:
+            Compare _comp;
+            map_value_compare(Compare c) : _comp(c) { }
+
+        public:
+            typedef bool        result_type;
+            typedef Value       first_argument_type;
+            typedef Value       second_argument_type;
+            bool    operator() (Value const &x, Value const &y) const {
+                return _comp(x.first, y.first);
+            }
+
+            // used by the tree to compare node values with a bare key
+            bool    operator() (Value const &x, Key const &k) const {
+                return _comp(x.first, k);
+            }
+
+            bool    operator() (Key const &k, Value const &y) const {
+                return _comp(k, y.first);
+            }
+
+            // used by the tree to check if a batch of keys is sorted
+            bool    operator() (Key const &k, Key const &l) const {
+                return _comp(k, l);
+            }
+    };
+
+// keys are compared without branches whenever they are for the key comparator
+template<class Key, class Value, class Compare>
+    struct is_arithmetic_less<map_value_compare<Key, Value, Compare> >
+        : public is_arithmetic_less<Compare> { };
+
+// a map compares three-way whenever its key comparator does
+template<class Key, class Value, class Compare>
+    struct three_way_compare<map_value_compare<Key, Value, Compare> > {
+        typedef map_value_compare<Key, Value, Compare>  value_compare;
+        typedef three_way_compare<Compare>              key_three_way;
+
+        static const bool value = key_three_way::value;
+
+        static int compare(value_compare const &c, Value const &x, Value const &y) {
+            return (key_three_way::compare(c._comp, x.first, y.first));
+        }
+
+        static int compare(value_compare const &c, Value const &x, Key const &k) {
+            return (key_three_way::compare(c._comp, x.first, k));
+        }
+
+        static int compare(value_compare const &c, Key const &k, Value const &y) {
+            return (key_three_way::compare(c._comp, k, y.first));
+        }
+    };
+
 template<class Key,
          class T,
          class Compare = std::less<const Key>,
-         class Alloc = std::allocator<ft::pair<const Key, T> >
+         class Alloc = typename ft::tree_default_allocator<ft::pair<const Key, T> >::type
         >
         class map {
 
@@ -40,24 +104,10 @@ template<class Key,
                 typedef typename allocator_type::const_pointer                      const_pointer;
                 typedef typename allocator_type::size_type                          size_type;
 
-                class value_compare {
-                    friend class map;
-
-                    protected:
-                        key_compare _comp;
-                        value_compare(Compare c) : _comp(c) { }
-                    
-                    public:
-                        typedef bool        result_type;
-                        typedef value_type  first_argument_type;
-                        typedef value_type  second_argument_type;
-                        bool    operator() (value_type const &x, value_type const &y) const {
-                            return _comp(x.first, y.first);
-                        }
-                };
+                typedef ft::map_value_compare<key_type, value_type, key_compare>    value_compare;
 
             private:
-                typedef RB_BST<value_type, value_compare, allocator_type> Tree;
+                typedef RB_BST<value_type, value_compare, allocator_type, key_type> Tree;
             
             public:
                 typedef typename Tree::iterator                                 iterator;
@@ -65,6 +115,11 @@ template<class Key,
                 typedef typename Tree::reverse_iterator                         reverse_iterator;
                 typedef typename Tree::const_reverse_iterator                   const_reverse_iterator;
                 typedef typename ft::iterator_traits<iterator>::difference_type difference_type;
+                // like std::auto_ptr, a copy of a node_type takes the node away
+                // from the copied handle, so a const handle cannot be copied
+                typedef ft::map_node_handle<typename Tree::Node, allocator_type,
+                    typename Tree::node_allocator_type>                         node_type;
+                typedef typename Tree::cursor                                   cursor;
 
             private:
                 Tree    _tree;
@@ -78,13 +133,15 @@ template<class Key,
                     map(InputIterator first, InputIterator last, 
                         const key_compare& comp = key_compare(),
                         const allocator_type& alloc = allocator_type()) : _tree(value_compare(comp), alloc) {
-                            for(; first != last; ++first) {
-                                _tree.insert(*first);
-                            }
+                            _tree.insert(first, last);
                         }
 
                 map(const map& x) : _tree(x._tree) { }
 
+# ifdef FT_CXX11
+                map(map&& x) : _tree(std::move(x._tree)) { }
+# endif
+
             /* ------- Destructor ------- */
                 ~map() { }
             
@@ -94,6 +151,13 @@ template<class Key,
                     return (*this);
                 }
 
+# ifdef FT_CXX11
+                map &operator=(map&& x) {
+                    _tree = std::move(x._tree);
+                    return (*this);
+                }
+# endif
+
             /* ------- Iterators ------- */
                 iterator    begin() { return _tree.begin(); }
                 
@@ -118,11 +182,28 @@ template<class Key,
 
                 size_type   max_size() const { return _tree.max_size(); }
 
+                void        reserve(size_type n) { _tree.reserve(n); }
+
             /* ------- Element Access ------- */
                 mapped_type& operator[](const key_type& k) {
-                    iterator    ret = insert(ft::make_pair(k, mapped_type())).first;
+                    iterator    ret = lower_bound(k);
+                    if (ret == end() || key_comp()(k, ret->first))
+# ifdef FT_CXX11
+                        ret = emplace_hint(ret, k, mapped_type());
+# else
+                        ret = insert(ret, value_type(k, mapped_type()));
+# endif
+                    return ret->second;
+                }
+
+# ifdef FT_CXX11
+                mapped_type& operator[](key_type&& k) {
+                    iterator    ret = lower_bound(k);
+                    if (ret == end() || key_comp()(k, ret->first))
+                        ret = emplace_hint(ret, std::move(k), mapped_type());
                     return ret->second;
                 }
+# endif
 
             /* ------- Modifiers ------- */
                 pair<iterator, bool> insert(const value_type& val) {
@@ -137,19 +218,80 @@ template<class Key,
                     void    insert(InputIterator first, InputIterator last) {
                         _tree.insert(first, last);
                     }
+
+# ifdef FT_CXX11
+                pair<iterator, bool> insert(value_type&& val) {
+                    return _tree.insert(std::move(val));
+                }
+
+                iterator    insert(iterator position, value_type&& val) {
+                    return _tree.insert(position, std::move(val));
+                }
+
+                template <class... Args>
+                    pair<iterator, bool>    emplace(Args&&... args) {
+                        return _tree.emplace(std::forward<Args>(args)...);
+                    }
+
+                template <class... Args>
+                    iterator    emplace_hint(const_iterator position, Args&&... args) {
+                        return _tree.emplace_hint(position, std::forward<Args>(args)...);
+                    }
+# endif
             
                 void    erase(iterator position) {
-                    _tree.deleteNode(position.base()->data);
+                    _tree.deleteNode(position);
                 }
 
                 size_type   erase(const key_type& k) {
-                    return _tree.deleteNode(ft::make_pair(k, mapped_type()));
+                    return _tree.deleteNode(k);
                 }
 
                 void    erase(iterator first, iterator last) {
                     _tree.deleteNode(first, last);
                 }
 
+                // node handles move entries between maps without copying them
+                node_type   extract(const_iterator position) {
+                    return node_type(_tree.extract(position));
+                }
+
+                node_type   extract(const key_type& k) {
+                    return node_type(_tree.extract(k));
+                }
+
+                pair<iterator, bool>    insert(node_type& nh) {
+                    return _tree.insert(nh);
+                }
+
+                // the result of extract() comes in here
+                pair<iterator, bool>    insert(typename Tree::node_ref_type ref) {
+                    return _tree.insert(ref);
+                }
+
+                iterator    insert(const_iterator hint, node_type& nh) {
+                    return _tree.insert(hint, nh);
+                }
+
+                iterator    insert(const_iterator hint, typename Tree::node_ref_type ref) {
+                    return _tree.insert(hint, ref);
+                }
+
+                void    merge(map& source) {
+                    _tree.merge(source._tree);
+                }
+
+                // a cursor seeks, inserts and erases from where it was left,
+                // which is cheap for keys close to each other. erase_here() at
+                // end() does nothing
+                cursor  make_cursor() {
+                    return cursor(_tree, begin());
+                }
+
+                cursor  make_cursor(iterator position) {
+                    return cursor(_tree, position);
+                }
+
                 void    swap(map& x) { _tree.swap(x._tree); }
 
                 void    clear() { _tree.clear(); }
@@ -165,41 +307,114 @@ template<class Key,
 
             /* ------- Operations ------- */
                 iterator   find(const key_type& k) {
-                    return _tree.find(ft::make_pair(k, mapped_type()));
+                    return _tree.find(k);
                 }
 
                 const_iterator find(const key_type& k) const {
-                    return _tree.find(ft::make_pair(k, mapped_type()));
+                    return _tree.find(k);
                 }
 
                 size_type   count(const key_type& k) const {
-                    return _tree.count(ft::make_pair(k, mapped_type()));
+                    return _tree.count(k);
                 }
+
+                // writes find(k) to out for every key k in [first, last). Keys are
+                // looked up in interleaved groups, sorted keys share their paths
+                template <class InputIterator, class OutputIterator>
+                    OutputIterator  find_many(InputIterator first, InputIterator last, OutputIterator out) {
+                        return _tree.find_many(first, last, out);
+                    }
+
+                template <class InputIterator, class OutputIterator>
+                    OutputIterator  find_many(InputIterator first, InputIterator last, OutputIterator out) const {
+                        return _tree.find_many(first, last, out);
+                    }
                 
                 iterator    lower_bound(const key_type& k) {
-                    return _tree.lower_bound(ft::make_pair(k, mapped_type()));
+                    return _tree.lower_bound(k);
                 }
 
                 const_iterator lower_bound(const key_type& k) const {
-                    return _tree.lower_bound(ft::make_pair(k, mapped_type()));
+                    return _tree.lower_bound(k);
                 }
 
                 iterator    upper_bound(const key_type& k) {
-                    return _tree.upper_bound(ft::make_pair(k, mapped_type()));
+                    return _tree.upper_bound(k);
                 }
 
                 const_iterator  upper_bound(const key_type& k) const {
-                    return _tree.upper_bound(ft::make_pair(k, mapped_type()));
+                    return _tree.upper_bound(k);
                 }
 
                 pair<const_iterator, const_iterator> equal_range(const key_type& k) const {
-                    return _tree.equal_range(ft::make_pair(k, mapped_type()));
+                    return _tree.equal_range(k);
                 }
                 
                 pair<iterator, iterator>    equal_range(const key_type& k) {
-                    return _tree.equal_range(ft::make_pair(k, mapped_type()));
+                    return _tree.equal_range(k);
                 }
             
+            /* ------- Order statistics ------- */
+                size_type   rank(const key_type& k) const {
+                    return _tree.rank(k);
+                }
+
+                iterator    select(size_type n) {
+                    return _tree.select(n);
+                }
+
+                const_iterator  select(size_type n) const {
+                    return _tree.select(n);
+                }
+
+                size_type   count_range(const key_type& lo, const key_type& hi) const {
+                    return _tree.count_range(lo, hi);
+                }
+
+            /* ------- Set operations ------- */
+                // out may be *this or other, on equal keys the entry of *this is taken.
+                // O(n + m), except when one side has m elements much fewer than the
+                // n of the other: an intersection, or a difference of the smaller *this,
+                // looks them up and a union or symmetric difference into the larger
+                // side merges them in place, both in O(m log(n / m + 1))
+                void    set_union(const map& other, map& out) const {
+                    _tree.set_union(other._tree, out._tree);
+                }
+
+                void    set_intersection(const map& other, map& out) const {
+                    _tree.set_intersection(other._tree, out._tree);
+                }
+
+                void    set_difference(const map& other, map& out) const {
+                    _tree.set_difference(other._tree, out._tree);
+                }
+
+                void    set_symmetric_difference(const map& other, map& out) const {
+                    _tree.set_symmetric_difference(other._tree, out._tree);
+                }
+
+            /* ------- Split and join ------- */
+                // appends the content of other, whose keys should all be greater
+                // than ours, in O(log n)
+                void    join(map& other) {
+                    _tree.join(other._tree);
+                }
+
+                // split and extract_range run in O(log n) and need the subtree
+                // sizes of -D FT_ORDER_STATISTICS: without them the size of a
+                // half could only be known by counting it
+# ifdef FT_ORDER_STATISTICS
+                // keeps the keys less than k, the others are moved into other
+                void    split(const key_type& k, map& other) {
+                    _tree.split(k, other._tree);
+                }
+
+                // moves the keys in [lo, hi] into out
+                void    extract_range(const key_type& lo, const key_type& hi, map& out) {
+                    _tree.extract_range(lo, hi, out._tree);
+                }
+# endif
+
             /* ------- Allocator ------- */
                 allocator_type  get_allocator() const {
                     return _tree.get_allocator() ;
@@ -210,6 +425,11 @@ template<class Key,
 		void swap (map<Key,T,Compare,Alloc>& x, map<Key,T,Compare,Alloc>& y) {
 			x.swap(y);
 		}
+
+	// a pooled allocator allocates its pool when default constructed
+	template <class Key, class T, class K>
+		struct has_cheap_swap<map<Key, T, std::less<K>, std::allocator<ft::pair<const Key, T> > > >
+			: public integral_constant<bool, has_cheap_default<Key>::value && has_cheap_default<T>::value> { };
 	
 	template< class Key, class T, class Compare, class Alloc >
 		bool operator==( const ft::map<Key,T,Compare,Alloc>& lhs, const ft::map<Key,T,Compare,Alloc>& rhs ) {
@@ -17,6 +17,7 @@
 # include "utils/Pair.hpp"
 # include "utils/Algorithm.hpp"
 # include "iterators/bst_bidirectional_iterator.hpp"
+# include "utils/PoolAllocator.hpp"
 # include "utils/RedBlackTree.hpp"
 
 
@@ -24,7 +25,7 @@ namespace ft {
 
     template < class T,                         //set::key_type/value_type
            class Compare = std::less<T>,        //set::key_compare/value_compare
-           class Alloc = std::allocator<T>      //set::allocator_type
+           class Alloc = typename ft::tree_default_allocator<T>::type      //set::allocator_type
            >
         class set {
 
@@ -49,6 +50,10 @@ namespace ft {
                 typedef typename Tree::const_reverse_iterator                   reverse_iterator;
                 typedef typename Tree::const_reverse_iterator                   const_reverse_iterator;
                 typedef typename ft::iterator_traits<iterator>::difference_type difference_type;
+                // like std::auto_ptr, a copy of a node_type takes the node away
+                // from the copied handle, so a const handle cannot be copied
+                typedef typename Tree::node_type                                node_type;
+                typedef typename Tree::template basic_cursor<const_iterator>   cursor;
 
             protected:
                 Tree    _tree;
@@ -61,13 +66,15 @@ namespace ft {
 				template <class InputIterator>
 					set (InputIterator first, InputIterator last,
 						const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type()) : _tree(value_compare(comp), alloc) {
-							for(; first  != last; first++) {
-								_tree.insert(*first);
-							}
+							_tree.insert(first, last);
 					}
 
 				set (const set& x) : _tree(x._tree) { }
 
+# ifdef FT_CXX11
+				set (set&& x) : _tree(std::move(x._tree)) { }
+# endif
+
 				/* ------ Destructor ------ */
 				~set() { }
 
@@ -77,6 +84,13 @@ namespace ft {
 					return *this;
 				}
 
+# ifdef FT_CXX11
+				set	&operator=(set &&other) {
+					_tree = std::move(other._tree);
+					return *this;
+				}
+# endif
+
 				/* ------ Iterators ------ */
 				iterator				begin()				{ return _tree.begin(); }
 				const_iterator			begin()		const	{ return _tree.begin(); };
@@ -91,6 +105,7 @@ namespace ft {
 				bool		empty()		const	{ return _tree.empty(); }
 				size_type	size()		const	{ return _tree.size(); }
 				size_type	max_size()	const	{ return _tree.max_size(); }
+				void		reserve(size_type n)	{ _tree.reserve(n); }
 
 				/* ------ Modifiers ------ */
 				ft::pair<iterator,bool>	insert (const value_type& val) {
@@ -98,8 +113,7 @@ namespace ft {
                 }
 
 				iterator	insert (iterator position, const value_type& val) {
-                    (void)position;
-                    return _tree.insert(_tree.begin(), val);
+                    return _tree.insert(position, val);
                 }
 
 				template <class InputIterator>
@@ -107,20 +121,53 @@ namespace ft {
                         _tree.insert(first, last);
                     }
 
+# ifdef FT_CXX11
+				ft::pair<iterator,bool>	insert (value_type&& val) {
+					return (_tree.insert(std::move(val)));
+				}
+
+				iterator	insert (iterator position, value_type&& val) {
+					return (_tree.insert(position, std::move(val)));
+				}
+
+				template <class... Args>
+					ft::pair<iterator,bool>	emplace (Args&&... args) {
+						return (_tree.emplace(std::forward<Args>(args)...));
+					}
+
+				template <class... Args>
+					iterator	emplace_hint (const_iterator position, Args&&... args) {
+						return (_tree.emplace_hint(position, std::forward<Args>(args)...));
+					}
+# endif
+
 				void	erase (iterator position) {
-                    _tree.deleteNode(*position);
+                    _tree.deleteNode(position);
                 }
 
 				size_type	erase (const value_type& val) {
                     return (_tree.deleteNode(val));
                 }
 
-				void	erase (iterator first, iterator last) { 
-					while (first != last) {
-						_tree.deleteNode(*first++);
-					}
+				void	erase (iterator first, iterator last) {
+					_tree.deleteNode(first, last);
 				}
 
+				// node handles move elements between sets without copying them
+				node_type	extract (const_iterator position)		{ return _tree.extract(position); }
+				node_type	extract (const value_type& val)			{ return _tree.extract(val); }
+				ft::pair<iterator,bool>	insert (node_type& nh)			{ return _tree.insert(nh); }
+				ft::pair<iterator,bool>	insert (typename Tree::node_ref_type ref)	{ return _tree.insert(ref); }
+				iterator	insert (const_iterator hint, node_type& nh)		{ return _tree.insert(hint, nh); }
+				iterator	insert (const_iterator hint, typename Tree::node_ref_type ref)	{ return _tree.insert(hint, ref); }
+				void		merge (set& source)						{ _tree.merge(source._tree); }
+
+				// a cursor seeks, inserts and erases from where it was left,
+				// which is cheap for values close to each other. erase_here() at
+				// end() does nothing
+				cursor	make_cursor ()					{ return cursor(_tree, begin()); }
+				cursor	make_cursor (iterator position)	{ return cursor(_tree, position); }
+
 				void	swap (set& x) { _tree.swap(x._tree); }
 
 				void	clear()	{ _tree.clear(); }
@@ -137,6 +184,13 @@ namespace ft {
                     return _tree.count(val);
                 }
 
+				// writes find(val) to out for every value in [first, last). Values are
+				// looked up in interleaved groups, sorted values share their paths
+				template <class InputIterator, class OutputIterator>
+					OutputIterator	find_many (InputIterator first, InputIterator last, OutputIterator out) const {
+						return _tree.find_many(first, last, out);
+					}
+
 				iterator    lower_bound (const value_type& val)	const {
                     return iterator(_tree.lower_bound(val).base());
                 }
@@ -149,6 +203,41 @@ namespace ft {
                     return _tree.equal_range(val);
                 }
 
+				/* ------ Order statistics ------ */
+				size_type	rank (const value_type& val) const	{ return _tree.rank(val); }
+				iterator	select (size_type n) const			{ return _tree.select(n); }
+				size_type	count_range (const value_type& lo, const value_type& hi) const {
+					return _tree.count_range(lo, hi);
+				}
+
+				/* ------ Set operations ------ */
+				// out may be *this or other. O(n + m), except when one side has m elements
+				// much fewer than the n of the other: an intersection, or a difference of
+				// the smaller *this, looks them up and a union or symmetric difference
+				// into the larger side merges them in place, both in O(m log(n / m + 1))
+				void	set_union (const set& other, set& out) const			{ _tree.set_union(other._tree, out._tree); }
+				void	set_intersection (const set& other, set& out) const		{ _tree.set_intersection(other._tree, out._tree); }
+				void	set_difference (const set& other, set& out) const		{ _tree.set_difference(other._tree, out._tree); }
+				void	set_symmetric_difference (const set& other, set& out) const	{ _tree.set_symmetric_difference(other._tree, out._tree); }
+
+				/* ------ Split and join ------ */
+				// appends the content of other, whose values should all be greater
+				// than ours, in O(log n)
+				void	join (set& other)	{ _tree.join(other._tree); }
+
+				// split and extract_range run in O(log n) and need the subtree
+				// sizes of -D FT_ORDER_STATISTICS: without them the size of a
+				// half could only be known by counting it
+# ifdef FT_ORDER_STATISTICS
+				// keeps the values less than val, the others are moved into other
+				void	split (const value_type& val, set& other)	{ _tree.split(val, other._tree); }
+
+				// moves the values in [lo, hi] into out
+				void	extract_range (const value_type& lo, const value_type& hi, set& out) {
+					_tree.extract_range(lo, hi, out._tree);
+				}
+# endif
+
 				/* ------ Allocator ------ */
 				allocator_type get_allocator() const { return _tree.get_allocator(); }
 
@@ -160,6 +249,9 @@ namespace ft {
 					x.swap(y);
 				}
 
+			template<class T, class K>
+				struct has_cheap_swap<set<T, std::less<K>, std::allocator<T> > > : public has_cheap_default<T> { };
+
 			template<class T, class Compare, class Alloc >
 				bool operator==( const ft::set<T, Compare, Alloc>& lhs, const ft::set<T, Compare, Alloc>& rhs ) {
 					if (lhs.size() != rhs.size())
@@ -40,6 +40,17 @@ template <class T, class Container = ft::vector<T> >
 
             explicit stack(const container_type& ctnr = container_type()) : c(ctnr) {}
 
+# ifdef FT_CXX11
+            explicit stack(container_type&& ctnr) : c(std::move(ctnr)) {}
+            stack(const stack &q) = default;
+            stack(stack &&q) = default;
+
+            stack   &operator=(stack &&q) {
+                c = std::move(q.c);
+                return (*this);
+            }
+# endif
+
             bool            empty() const {
                 return c.empty();
             }
@@ -55,9 +66,21 @@ template <class T, class Container = ft::vector<T> >
             void            push(const value_type& val) {
                 c.push_back(val);
             }
+# ifdef FT_CXX11
+            void            push(value_type&& val) {
+                c.push_back(std::move(val));
+            }
+            template <class... Args>
+                void        emplace(Args&&... args) {
+                    c.emplace_back(std::forward<Args>(args)...);
+                }
+# endif
             void            pop() {
                 c.pop_back();
             }
+            void            swap(stack &x) {
+                c.swap(x.c);
+            }
 
             template <class T1, class _C1>
                 friend bool operator==(const stack<T1, _C1>& __x, const stack<T1, _C1>& __y);
@@ -65,6 +88,14 @@ template <class T, class Container = ft::vector<T> >
                 friend bool operator< (const stack<T1, _C1>& __x, const stack<T1, _C1>& __y);
     };
 
+template <class T, class Container>
+  void swap(stack<T,Container>& x, stack<T,Container>& y) {
+      x.swap(y);
+  }
+
+template <class T, class Container>
+  struct has_cheap_swap<stack<T, Container> > : public has_cheap_swap<Container> { };
+
 template <class T, class Container>
   bool operator== (const stack<T,Container>& lhs, const stack<T,Container>& rhs) {
       return lhs.c == rhs.c;
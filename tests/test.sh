@@ -1,16 +1,19 @@
 #!/bin/bash
 
 # run this script from ft_containers directory!
+# STD=c++11 ./tests/test.sh builds the tests with move semantics and emplace
+
+STD=${STD:-c++98}
 
 make clean
 
 mkdir ./tests/logs
 
 echo TEST1:
-c++ -Wall -Wextra -Werror -std=c++98 -D BUILD_STD=1 ./tests/test1.cpp -o std_containers1
+c++ -Wall -Wextra -Werror -std=$STD -D BUILD_STD=1 ./tests/test1.cpp -o std_containers1
 echo Time std:
 time ./std_containers1 seed > ./tests/logs/output_std1
-c++ -Wall -Wextra -Werror -std=c++98 ./tests/test1.cpp -o ft_containers1
+c++ -Wall -Wextra -Werror -std=$STD ./tests/test1.cpp -o ft_containers1
 echo
 echo Time ft:
 time ./ft_containers1 seed > ./tests/logs/output_ft1
@@ -26,10 +29,10 @@ fi
 
 echo
 echo TEST2:
-c++ -Wall -Wextra -Werror -std=c++98 -D STDSTL=1 ./tests/test2.cpp -o std_containers2
+c++ -Wall -Wextra -Werror -std=$STD -D STDSTL=1 ./tests/test2.cpp -o std_containers2
 echo Time std:
 time ./std_containers2 seed > ./tests/logs/output_std2
-c++ -Wall -Wextra -Werror -std=c++98 ./tests/test2.cpp -o ft_containers2
+c++ -Wall -Wextra -Werror -std=$STD ./tests/test2.cpp -o ft_containers2
 echo
 echo Time ft:
 time ./ft_containers2 seed > ./tests/logs/output_ft2
@@ -45,10 +48,10 @@ fi
 
 echo
 echo TEST3:
-c++ -Wall -Wextra -Werror -std=c++98 ./tests/test3.cpp -o std_containers3
+c++ -Wall -Wextra -Werror -std=$STD ./tests/test3.cpp -o std_containers3
 echo Time std:
 time ./std_containers3 seed > ./tests/logs/output_std3
-c++ -Wall -Wextra -Werror -std=c++98 -D FT ./tests/test3.cpp -o ft_containers3
+c++ -Wall -Wextra -Werror -std=$STD -D FT ./tests/test3.cpp -o ft_containers3
 echo
 echo Time ft:
 time ./ft_containers3 seed > ./tests/logs/output_ft3
@@ -6,10 +6,14 @@
 #include <stack>
 #include <vector>
 #include <set>
+#include <algorithm>
+#include <iterator>
+#include <sstream>
 #include "../map.hpp"
 #include "../stack.hpp"
 #include "../vector.hpp"
 #include "../set.hpp"
+#include "../frozen_map.hpp"
 #define TESTED_NAMESPACE ft
 #ifdef STDSTL
 # undef TESTED_NAMESPACE
@@ -36,6 +40,35 @@ std::ostream &operator<<(std::ostream &os, const TESTED_NAMESPACE::pair<first, s
 template <typename Key>
 std::ostream &operator<<(std::ostream &os, const TESTED_NAMESPACE::set<Key>& s);
 
+// counts how often the containers call their comparator
+static long	g_compare_calls = 0;
+
+struct counting_less
+{
+	bool	operator()(const std::string &a, const std::string &b) const
+	{
+		++g_compare_calls;
+		return (a < b);
+	}
+};
+
+#ifndef STDSTL
+namespace ft
+{
+	template <>
+		struct three_way_compare<counting_less>
+		{
+			static const bool value = true;
+
+			static int	compare(const counting_less &, const std::string &a, const std::string &b)
+			{
+				++g_compare_calls;
+				return (a.compare(b));
+			}
+		};
+}
+#endif
+
 int main(int argc, char** argv)
 {
 	if (argc != 2)
@@ -185,6 +218,25 @@ int main(int argc, char** argv)
 			TESTED_NAMESPACE::vector<int> vectorTest4(vectorTest2.begin(), vectorTest2.end());
 			LOG("vectorTest4: " << vectorTest4);
 			LOG("vectorTest2: " << vectorTest2);
+		// insert of an element of the vector itself
+			{
+				TESTED_NAMESPACE::vector<std::string>	words;
+				words.push_back("first");
+				words.push_back("second");
+				words.push_back("third");
+				words.reserve(20);
+				LOG("words.insert(words.begin(), words[0]);"); words.insert(words.begin(), words[0]);
+				LOG("words.insert(words.begin(), words[2]);"); words.insert(words.begin(), words[2]);
+				LOG("words.insert(words.begin() + 1, 2, words.back());"); words.insert(words.begin() + 1, 2, words.back());
+				LOG("words.insert(words.end() - 1, 4, words[1]);"); words.insert(words.end() - 1, 4, words[1]);
+				LOG("words: " << words);
+				TESTED_NAMESPACE::vector<std::string>	full(4, "full");
+				full[3] = "last";
+				LOG("full.capacity() == full.size(): " << (full.capacity() == full.size()));
+				LOG("full.insert(full.begin(), full[3]);"); full.insert(full.begin(), full[3]);
+				LOG("full.insert(full.begin(), full.size() * 2, full[0]);"); full.insert(full.begin(), full.size() * 2, full[0]);
+				LOG("full: " << full);
+			}
 	// Performance test
 		clock_t begin = std::clock();
 		LOG("push_back 100.000.000 ints");
@@ -200,6 +252,54 @@ int main(int argc, char** argv)
 		begin = std::clock();
 		LOG("vectorTest2.assign(vectorTest5.begin(), vectorTest5.end());"); vectorTest2.assign(vectorTest5.begin(), vectorTest5.end());
 		LOG("Time taken: " << static_cast<double>((std::clock() - begin)) / CLOCKS_PER_SEC << " seconds");
+		begin = std::clock();
+		LOG("vectorTest6(vectorTest5.begin(), vectorTest5.end());");
+		TESTED_NAMESPACE::vector<int> vectorTest6(vectorTest5.begin(), vectorTest5.end());
+		LOG("vectorTest6.size(): " << vectorTest6.size());
+		LOG("Time taken: " << static_cast<double>((std::clock() - begin)) / CLOCKS_PER_SEC << " seconds");
+		begin = std::clock();
+		LOG("vectorTest6.insert(vectorTest6.begin() + 10, vectorTest5.begin(), vectorTest5.end());");
+		vectorTest6.insert(vectorTest6.begin() + 10, vectorTest5.begin(), vectorTest5.end());
+		LOG("vectorTest6.size(): " << vectorTest6.size());
+		LOG("Time taken: " << static_cast<double>((std::clock() - begin)) / CLOCKS_PER_SEC << " seconds");
+		{
+			std::stringstream	stream;
+			for (int i = 0; i < 1000000; ++i)
+				stream << i << ' ';
+			begin = std::clock();
+			LOG("vectorTest7(std::istream_iterator<int>(stream), std::istream_iterator<int>());");
+			TESTED_NAMESPACE::vector<int> vectorTest7((std::istream_iterator<int>(stream)), std::istream_iterator<int>());
+			LOG("vectorTest7.size(): " << vectorTest7.size() << ", vectorTest7.back(): " << vectorTest7.back());
+			LOG("Time taken: " << static_cast<double>((std::clock() - begin)) / CLOCKS_PER_SEC << " seconds");
+		}
+		{
+			// elements are copied on growth in C++98, moved with -std=c++11
+			TESTED_NAMESPACE::vector<std::string>	strings;
+			const std::string						line(64, 'x');
+			begin = std::clock();
+			LOG("push_back 2.000.000 strings of 64 chars");
+			for (int i = 0; i < 2000000; ++i)
+				strings.push_back(line);
+			LOG("strings.size(): " << strings.size());
+			LOG("Time taken: " << static_cast<double>((std::clock() - begin)) / CLOCKS_PER_SEC << " seconds");
+			begin = std::clock();
+			LOG("insert 200 strings at the front");
+			for (int i = 0; i < 200; ++i)
+				strings.insert(strings.begin(), line);
+			LOG("strings.size(): " << strings.size());
+			LOG("Time taken: " << static_cast<double>((std::clock() - begin)) / CLOCKS_PER_SEC << " seconds");
+		}
+		{
+			// in C++98 the inner vectors are swapped instead of copied on growth
+			TESTED_NAMESPACE::vector<TESTED_NAMESPACE::vector<int> >	nested;
+			const TESTED_NAMESPACE::vector<int>							row(100, 42);
+			begin = std::clock();
+			LOG("push_back 200.000 vectors of 100 ints");
+			for (int i = 0; i < 200000; ++i)
+				nested.push_back(row);
+			LOG("nested.size(): " << nested.size() << ", nested.back().size(): " << nested.back().size());
+			LOG("Time taken: " << static_cast<double>((std::clock() - begin)) / CLOCKS_PER_SEC << " seconds");
+		}
 	}
 	LOG("Leak check:");
 	#ifndef STDSTL
@@ -328,6 +428,434 @@ int main(int argc, char** argv)
 			LOG("mapKeyComp(3, 6): " << mapKeyComp(3, 6));
 			LOG("mapValueComp(*mapTest3.find(0), *mapTest3.find(14)): " << mapValueComp.operator()(*mapTest3.find(0), *mapTest3.find(14)));
 			LOG("mapValueComp(*mapTest3.find(14), *mapTest3.find(0)): " << mapValueComp.operator()(*mapTest3.find(14), *mapTest3.find(0)));
+		// split, join, extract_range
+		{
+			TESTED_NAMESPACE::map<int, int> lower;
+			TESTED_NAMESPACE::map<int, int> upper;
+			LOG("split of an empty map:");
+			#if !defined(STDSTL) && defined(FT_ORDER_STATISTICS)
+				lower.split(5, upper);
+			#endif
+			LOG("lower: " << lower << "| upper: " << upper);
+			for (int i = 0; i < 10; ++i)
+				lower.insert(TESTED_NAMESPACE::make_pair(i * 2, i));
+			// below the minimum, the minimum, a missing key, a key, the maximum, above the maximum
+			int splitKeys[] = { -1, 0, 7, 8, 18, 19 };
+			for (size_t k = 0; k < sizeof(splitKeys) / sizeof(*splitKeys); ++k)
+			{
+				#if !defined(STDSTL) && defined(FT_ORDER_STATISTICS)
+					lower.split(splitKeys[k], upper);
+				#else
+					upper.clear();
+					upper.insert(lower.lower_bound(splitKeys[k]), lower.end());
+					lower.erase(lower.lower_bound(splitKeys[k]), lower.end());
+				#endif
+				LOG("split(" << splitKeys[k] << "): " << lower << "| " << upper);
+				#ifndef STDSTL
+					lower.join(upper);
+				#else
+					lower.insert(upper.begin(), upper.end());
+					upper.clear();
+				#endif
+				LOG("join: " << lower << "| " << upper << "size: " << lower.size() << " " << upper.size());
+			}
+			LOG("join into an empty map:");
+			#ifndef STDSTL
+				upper.join(lower);
+			#else
+				upper.swap(lower);
+			#endif
+			LOG("lower: " << lower << "| upper: " << upper);
+			TESTED_NAMESPACE::map<int, int> overlap;
+			overlap.insert(TESTED_NAMESPACE::make_pair(1, 100));
+			overlap.insert(TESTED_NAMESPACE::make_pair(4, 100));
+			overlap.insert(TESTED_NAMESPACE::make_pair(25, 100));
+			LOG("join of keys that are not all greater:");
+			#ifndef STDSTL
+				upper.join(overlap);
+			#else
+				upper.insert(overlap.begin(), overlap.end());
+				overlap.clear();
+			#endif
+			LOG("upper: " << upper << "| overlap: " << overlap);
+			// a range inside, a range without keys, everything, a range of an empty map
+			int rangeKeys[][2] = { { 5, 11 }, { 19, 24 }, { -10, 100 }, { 0, 10 } };
+			TESTED_NAMESPACE::map<int, int> range;
+			for (size_t k = 0; k < sizeof(rangeKeys) / sizeof(*rangeKeys); ++k)
+			{
+				#if !defined(STDSTL) && defined(FT_ORDER_STATISTICS)
+					upper.extract_range(rangeKeys[k][0], rangeKeys[k][1], range);
+				#else
+					range.clear();
+					range.insert(upper.lower_bound(rangeKeys[k][0]), upper.upper_bound(rangeKeys[k][1]));
+					upper.erase(upper.lower_bound(rangeKeys[k][0]), upper.upper_bound(rangeKeys[k][1]));
+				#endif
+				LOG("extract_range(" << rangeKeys[k][0] << ", " << rangeKeys[k][1] << "): " << upper << "| " << range);
+			}
+		}
+		// set_union of maps takes the entry of *this on equal keys
+		{
+			TESTED_NAMESPACE::map<int, std::string> first;
+			TESTED_NAMESPACE::map<int, std::string> second;
+			for (int i = 0; i < 6; ++i)
+			{
+				first.insert(TESTED_NAMESPACE::make_pair(i * 2, "first"));
+				second.insert(TESTED_NAMESPACE::make_pair(i * 3, "second"));
+			}
+			TESTED_NAMESPACE::map<int, std::string> result;
+			#ifndef STDSTL
+				first.set_union(second, result);
+			#else
+				std::set_union(first.begin(), first.end(), second.begin(), second.end(),
+					std::inserter(result, result.end()), first.value_comp());
+			#endif
+			LOG("first.set_union(second, result): " << result);
+			// merged into a much larger out, the entries of *this still win
+			TESTED_NAMESPACE::map<int, std::string> wide;
+			for (int i = 0; i < 200; ++i)
+				wide.insert(TESTED_NAMESPACE::make_pair(i, "wide"));
+			#ifndef STDSTL
+				first.set_union(wide, wide);
+			#else
+				for (TESTED_NAMESPACE::map<int, std::string>::iterator it = first.begin(); it != first.end(); ++it)
+					wide[it->first] = it->second;
+			#endif
+			LOG("first.set_union(wide, wide): " << wide.size() << " " << wide[4] << " " << wide[5] << " " << wide[10]);
+		}
+		// extract, insert and merge of node handles
+		{
+			TESTED_NAMESPACE::map<int, std::string> src;
+			TESTED_NAMESPACE::map<int, std::string> dst;
+			for (int i = 0; i < 8; ++i)
+				src.insert(TESTED_NAMESPACE::make_pair(i, "src"));
+			dst.insert(TESTED_NAMESPACE::make_pair(3, "dst"));
+			dst.insert(TESTED_NAMESPACE::make_pair(10, "dst"));
+			#ifndef STDSTL
+				typedef TESTED_NAMESPACE::map<int, std::string>::node_type	node_type;
+				node_type	nh;
+				LOG("default handle empty: " << nh.empty());
+				nh = src.extract(src.begin());
+				LOG("extract(begin()): " << nh.key() << " " << nh.mapped() << " | src: " << src);
+				nh.mapped() = "moved";
+				TESTED_NAMESPACE::pair<TESTED_NAMESPACE::map<int, std::string>::iterator, bool> ret = dst.insert(nh);
+				LOG("dst.insert(nh): " << *ret.first << " " << ret.second << " handle empty: " << nh.empty());
+				ret = dst.insert(src.extract(3));
+				LOG("dst.insert(src.extract(3)): " << *ret.first << " " << ret.second);
+				nh = src.extract(42);
+				LOG("src.extract(42) empty: " << nh.empty());
+				ret = dst.insert(nh);
+				LOG("dst.insert(empty): " << (ret.first == dst.end()) << " " << ret.second);
+				nh = src.extract(5);
+				dst.insert(TESTED_NAMESPACE::make_pair(5, "dst"));
+				ret = dst.insert(nh);
+				LOG("dst.insert(nh) on an existing key: " << *ret.first << " " << ret.second << " handle kept: " << nh.key());
+				LOG("dst.insert(end(), src.extract(6)): " << *dst.insert(dst.end(), src.extract(6)));
+			#else
+				LOG("default handle empty: " << 1);
+				TESTED_NAMESPACE::pair<int, std::string> value = *src.begin();
+				src.erase(src.begin());
+				LOG("extract(begin()): " << value.first << " " << value.second << " | src: " << src);
+				value.second = "moved";
+				TESTED_NAMESPACE::pair<TESTED_NAMESPACE::map<int, std::string>::iterator, bool> ret = dst.insert(value);
+				LOG("dst.insert(nh): " << *ret.first << " " << ret.second << " handle empty: " << 1);
+				value = *src.find(3);
+				src.erase(3);
+				ret = dst.insert(value);
+				LOG("dst.insert(src.extract(3)): " << *ret.first << " " << ret.second);
+				LOG("src.extract(42) empty: " << 1);
+				LOG("dst.insert(empty): " << 1 << " " << 0);
+				value = *src.find(5);
+				src.erase(5);
+				dst.insert(TESTED_NAMESPACE::make_pair(5, "dst"));
+				ret = dst.insert(value);
+				LOG("dst.insert(nh) on an existing key: " << *ret.first << " " << ret.second << " handle kept: " << value.first);
+				value = *src.find(6);
+				src.erase(6);
+				LOG("dst.insert(end(), src.extract(6)): " << *dst.insert(dst.end(), value));
+			#endif
+			LOG("src: " << src << "| dst: " << dst);
+			for (int i = 0; i < 4; ++i)
+				src.insert(TESTED_NAMESPACE::make_pair(i * 4, "src"));
+			LOG("src: " << src);
+			#ifndef STDSTL
+				dst.merge(src);
+				dst.merge(dst);
+			#else
+				for (TESTED_NAMESPACE::map<int, std::string>::iterator it = src.begin(); it != src.end();)
+				{
+					if (dst.insert(*it).second)
+						src.erase(it++);
+					else
+						++it;
+				}
+			#endif
+			LOG("dst.merge(src): " << dst << "| src: " << src);
+			// the nodes of maps with separate pools are copied
+			typedef TESTED_NAMESPACE::map<int, std::string, std::less<int>,
+				ft::pool_allocator<TESTED_NAMESPACE::pair<const int, std::string> > >	pool_map;
+			pool_map	poolSrc;
+			pool_map	poolDst;
+			for (int i = 0; i < 4; ++i)
+				poolSrc.insert(TESTED_NAMESPACE::make_pair(i, "pool"));
+			poolDst.insert(TESTED_NAMESPACE::make_pair(2, "dst"));
+			#ifndef STDSTL
+				poolDst.insert(poolSrc.extract(1));
+				poolDst.insert(poolDst.begin(), poolSrc.extract(3));
+				poolDst.merge(poolSrc);
+			#else
+				poolDst.insert(*poolSrc.find(1));
+				poolSrc.erase(1);
+				poolDst.insert(*poolSrc.find(3));
+				poolSrc.erase(3);
+				for (pool_map::iterator it = poolSrc.begin(); it != poolSrc.end();)
+				{
+					if (poolDst.insert(*it).second)
+						poolSrc.erase(it++);
+					else
+						++it;
+				}
+			#endif
+			for (pool_map::iterator it = poolDst.begin(); it != poolDst.end(); ++it)
+				LOG("poolDst: " << *it);
+			for (pool_map::iterator it = poolSrc.begin(); it != poolSrc.end(); ++it)
+				LOG("poolSrc: " << *it);
+			LOG("poolDst.max_size() == dst.max_size(): " << (poolDst.max_size() == dst.max_size()));
+			pool_map	poolCopy(poolDst);
+			LOG("a copy shares the pool: " << (poolCopy.get_allocator() == poolDst.get_allocator()) << " size: " << poolCopy.size());
+		}
+		// rank, select, count_range
+		{
+			TESTED_NAMESPACE::map<int, int> orderTest;
+			TESTED_NAMESPACE::map<int, int> emptyOrder;
+			for (int i = 0; i < 20; ++i)
+				orderTest.insert(TESTED_NAMESPACE::make_pair(i * 5, i));
+			orderTest.erase(35);
+			orderTest.erase(40);
+			// below the minimum, the minimum, missing keys, an erased key, the maximum, above it
+			int orderKeys[] = { -3, 0, 12, 35, 50, 95, 96 };
+			for (size_t k = 0; k < sizeof(orderKeys) / sizeof(*orderKeys); ++k)
+			{
+				#ifndef STDSTL
+					LOG("rank(" << orderKeys[k] << "): " << orderTest.rank(orderKeys[k])
+						<< " empty: " << emptyOrder.rank(orderKeys[k]));
+				#else
+					LOG("rank(" << orderKeys[k] << "): " << std::distance(orderTest.begin(), orderTest.lower_bound(orderKeys[k]))
+						<< " empty: " << 0);
+				#endif
+			}
+			for (size_t n = 0; n <= orderTest.size(); n += 3)
+			{
+				#ifndef STDSTL
+					TESTED_NAMESPACE::map<int, int>::iterator it = orderTest.select(n);
+				#else
+					TESTED_NAMESPACE::map<int, int>::iterator it = orderTest.begin();
+					std::advance(it, n);
+				#endif
+				if (it == orderTest.end())
+					LOG("select(" << n << "): end()");
+				else
+					LOG("select(" << n << "): " << *it);
+			}
+			TESTED_NAMESPACE::map<int, int>::iterator advanced = orderTest.end();
+			TESTED_NAMESPACE::advance(advanced, -5);
+			LOG("advance(end(), -5): " << *advanced);
+			TESTED_NAMESPACE::advance(advanced, 4);
+			LOG("advance(it, 4): " << *advanced);
+			#ifndef STDSTL
+				LOG("select(size()) == end(): " << (orderTest.select(orderTest.size()) == orderTest.end())
+					<< " empty: " << (emptyOrder.select(0) == emptyOrder.end()));
+			#else
+				LOG("select(size()) == end(): " << 1 << " empty: " << 1);
+			#endif
+			int countKeys[][2] = { { 0, 95 }, { 12, 48 }, { 35, 40 }, { 36, 39 }, { -10, -1 }, { 96, 200 }, { 50, 10 }, { 45, 45 } };
+			for (size_t k = 0; k < sizeof(countKeys) / sizeof(*countKeys); ++k)
+			{
+				int lo = countKeys[k][0];
+				int hi = countKeys[k][1];
+				#ifndef STDSTL
+					LOG("count_range(" << lo << ", " << hi << "): " << orderTest.count_range(lo, hi)
+						<< " empty: " << emptyOrder.count_range(lo, hi));
+				#else
+					LOG("count_range(" << lo << ", " << hi << "): "
+						<< (lo > hi ? 0 : std::distance(orderTest.lower_bound(lo), orderTest.upper_bound(hi)))
+						<< " empty: " << 0);
+				#endif
+			}
+		}
+		// find_many
+		{
+			TESTED_NAMESPACE::map<int, int> batchTest;
+			TESTED_NAMESPACE::map<int, int> emptyBatch;
+			for (int i = 0; i < 100; ++i)
+				batchTest.insert(TESTED_NAMESPACE::make_pair(i * 3, i));
+			std::vector<int> keys;
+			for (int i = -6; i < 310; i += 4)
+				keys.push_back(i);
+			std::vector<int> unsorted(keys.rbegin(), keys.rend());
+			unsorted.push_back(0);
+			unsorted.push_back(297);
+			unsorted.push_back(0);
+			std::vector<int> noKeys;
+			std::vector<int> *batches[] = { &keys, &unsorted, &noKeys };
+			for (size_t b = 0; b < sizeof(batches) / sizeof(*batches); ++b)
+			{
+				std::vector<TESTED_NAMESPACE::map<int, int>::iterator> found(batches[b]->size());
+				std::vector<TESTED_NAMESPACE::map<int, int>::iterator> missing(batches[b]->size());
+				#ifndef STDSTL
+					LOG("find_many returns the end of the output: "
+						<< (batchTest.find_many(batches[b]->begin(), batches[b]->end(), found.begin()) == found.end()));
+					emptyBatch.find_many(batches[b]->begin(), batches[b]->end(), missing.begin());
+				#else
+					LOG("find_many returns the end of the output: " << 1);
+					for (size_t k = 0; k < batches[b]->size(); ++k)
+					{
+						found[k] = batchTest.find((*batches[b])[k]);
+						missing[k] = emptyBatch.find((*batches[b])[k]);
+					}
+				#endif
+				std::ostringstream	out;
+				size_t				hits = 0;
+				for (size_t k = 0; k < found.size(); ++k)
+				{
+					if (found[k] == batchTest.end())
+						out << (*batches[b])[k] << ":end ";
+					else
+						out << (*batches[b])[k] << ":" << found[k]->second << " ";
+					hits += (missing[k] != emptyBatch.end());
+				}
+				LOG("find_many: " << out.str());
+				LOG("found in an empty map: " << hits);
+			}
+			TESTED_NAMESPACE::set<int> batchSet(keys.begin(), keys.end());
+			std::vector<TESTED_NAMESPACE::set<int>::const_iterator> inSet(unsorted.size());
+			#ifndef STDSTL
+				batchSet.find_many(unsorted.begin(), unsorted.end(), inSet.begin());
+			#else
+				for (size_t k = 0; k < unsorted.size(); ++k)
+					inSet[k] = batchSet.find(unsorted[k]);
+			#endif
+			size_t	setHits = 0;
+			for (size_t k = 0; k < inSet.size(); ++k)
+				setHits += (inSet[k] != batchSet.end() && *inSet[k] == unsorted[k]);
+			LOG("set find_many hits: " << setHits << " of " << inSet.size());
+		}
+		// frozen_map lookups and iteration
+		{
+			int frozenSizes[] = { 0, 1, 2, 7, 10, 100 };
+			for (size_t n = 0; n < sizeof(frozenSizes) / sizeof(*frozenSizes); ++n)
+			{
+				TESTED_NAMESPACE::map<int, int> buildTest;
+				for (int i = 0; i < frozenSizes[n]; ++i)
+					buildTest.insert(TESTED_NAMESPACE::make_pair(i * 2, i * i));
+				#ifndef STDSTL
+					ft::frozen_map<int, int> frozen(buildTest);
+					const ft::frozen_map<int, int> readTest(frozen);
+					typedef ft::frozen_map<int, int>::const_iterator	frozen_iterator;
+				#else
+					const std::map<int, int> &readTest = buildTest;
+					typedef std::map<int, int>::const_iterator	frozen_iterator;
+				#endif
+				std::ostringstream	forward;
+				std::ostringstream	backward;
+				for (frozen_iterator it = readTest.begin(); it != readTest.end(); ++it)
+					forward << it->first << ":" << (*it).second << " ";
+				for (frozen_iterator it = readTest.end(); it != readTest.begin();)
+				{
+					--it;
+					backward << it->first << " ";
+				}
+				LOG("frozen size " << readTest.size() << " empty " << readTest.empty() << ": " << forward.str());
+				LOG("backward: " << backward.str());
+				std::ostringstream	lookups;
+				for (int key = -1; key <= frozenSizes[n] * 2; ++key)
+				{
+					frozen_iterator	found = readTest.find(key);
+					frozen_iterator	lower = readTest.lower_bound(key);
+					frozen_iterator	upper = readTest.upper_bound(key);
+					lookups << key << ":" << (found == readTest.end() ? -1 : found->second)
+						<< "," << (lower == readTest.end() ? -1 : lower->first)
+						<< "," << (upper == readTest.end() ? -1 : upper->first)
+						<< "," << readTest.count(key)
+						<< "," << (readTest.equal_range(key).first == lower) << " ";
+					try
+					{
+						lookups << readTest.at(key) << " ";
+					}
+					catch (std::out_of_range &)
+					{
+						lookups << "out_of_range ";
+					}
+				}
+				LOG("lookups: " << lookups.str());
+			}
+		}
+		// cursor seek, insert_near and erase_here
+		{
+			TESTED_NAMESPACE::map<int, int> cursorTest;
+			for (int i = 0; i <= 40; i += 4)
+				cursorTest.insert(TESTED_NAMESPACE::make_pair(i, i));
+			#ifndef STDSTL
+				TESTED_NAMESPACE::map<int, int>::cursor cursor = cursorTest.make_cursor();
+				#define CURSOR_POSITION cursor.position()
+			#else
+				TESTED_NAMESPACE::map<int, int>::iterator position = cursorTest.begin();
+				#define CURSOR_POSITION position
+			#endif
+			// seek near, far, back, below the minimum and past the maximum, insert
+			// new and existing keys, erase up to end() and once more at end(),
+			// erase everything and work on the empty map
+			struct { char op; int key; } steps[] = {
+				{ 's', 4 }, { 's', 5 }, { 's', 36 }, { 's', 2 }, { 's', -7 }, { 's', 41 }, { 's', 12 },
+				{ 'i', 13 }, { 'i', 13 }, { 'i', 50 }, { 'i', -1 }, { 's', 36 },
+				{ 'e', 0 }, { 'e', 0 }, { 'e', 0 }, { 'e', 0 }, { 'i', 60 }, { 's', -5 },
+				{ 'e', 0 }, { 'e', 0 }, { 'e', 0 }, { 'e', 0 }, { 'e', 0 }, { 'e', 0 }, { 'e', 0 },
+				{ 'e', 0 }, { 'e', 0 }, { 'e', 0 }, { 'e', 0 }, { 'e', 0 }, { 'e', 0 }, { 'e', 0 },
+				{ 's', 3 }, { 'e', 0 }, { 'i', 3 }, { 'i', 1 }, { 'e', 0 }, { 'e', 0 }, { 'e', 0 }
+			};
+			for (size_t k = 0; k < sizeof(steps) / sizeof(*steps); ++k)
+			{
+				std::ostringstream	out;
+				if (steps[k].op == 's')
+				{
+					#ifndef STDSTL
+						bool found = cursor.seek(steps[k].key);
+					#else
+						position = cursorTest.lower_bound(steps[k].key);
+						bool found = (position != cursorTest.end() && position->first == steps[k].key);
+					#endif
+					out << "seek(" << steps[k].key << "): " << found;
+				}
+				else if (steps[k].op == 'i')
+				{
+					#ifndef STDSTL
+						TESTED_NAMESPACE::pair<TESTED_NAMESPACE::map<int, int>::iterator, bool> ret
+							= cursor.insert_near(TESTED_NAMESPACE::make_pair(steps[k].key, -steps[k].key));
+					#else
+						TESTED_NAMESPACE::pair<TESTED_NAMESPACE::map<int, int>::iterator, bool> ret
+							= cursorTest.insert(TESTED_NAMESPACE::make_pair(steps[k].key, -steps[k].key));
+						position = ret.first;
+					#endif
+					out << "insert_near(" << steps[k].key << "): " << *ret.first << " " << ret.second;
+				}
+				else
+				{
+					#ifndef STDSTL
+						cursor.erase_here();
+					#else
+						if (position != cursorTest.end())
+							cursorTest.erase(position++);
+					#endif
+					out << "erase_here()";
+				}
+				if (CURSOR_POSITION == cursorTest.end())
+					out << ", at end()";
+				else
+					out << ", at " << *CURSOR_POSITION;
+				LOG(out.str() << ", " << cursorTest.size() << " elements");
+			}
+			#undef CURSOR_POSITION
+			LOG("cursorTest: " << cursorTest);
+		}
 	// Performance test
 		LOG("Insert 10.000.000 pairs without hint");
 		clock_t begin = std::clock();
@@ -357,6 +885,270 @@ int main(int argc, char** argv)
 		for (size_t i = 0; i < 10000000; ++i)
 			mapTest.erase(std::rand() % 10000000);
 		LOG("mapTest.size(): " << mapTest.size());
+
+		LOG("10.000.000 find/count queries on 1.000.000 elements");
+		{
+			TESTED_NAMESPACE::map<int, int> findTest;
+			for (int i = 0; i < 1000000; ++i)
+				findTest.insert(TESTED_NAMESPACE::make_pair(std::rand() % 2000000, i));
+			long	checksum = 0;
+			begin = std::clock();
+			for (int i = 0; i < 10000000; ++i)
+			{
+				TESTED_NAMESPACE::map<int, int>::iterator it = findTest.find(std::rand() % 2000000);
+				if (it != findTest.end())
+					checksum += it->second;
+				checksum += findTest.count(std::rand() % 2000000);
+			}
+			LOG("findTest.size(): " << findTest.size() << " checksum: " << checksum);
+			LOG("Time taken: " << static_cast<double>((std::clock() - begin)) / CLOCKS_PER_SEC << " seconds");
+		}
+
+		LOG("5 scans of 4.000.000 elements, with ~40 multiplications per element and bare");
+		{
+			TESTED_NAMESPACE::map<int, int> scanTest;
+			for (int i = 0; i < 4000000; ++i)
+				scanTest.insert(TESTED_NAMESPACE::make_pair(std::rand(), i));
+			for (int work = 40; work >= 0; work -= 40)
+			{
+				unsigned long	checksum = 0;
+				begin = std::clock();
+				for (int pass = 0; pass < 5; ++pass)
+				{
+					TESTED_NAMESPACE::map<int, int>::const_iterator end = scanTest.end();
+					for (TESTED_NAMESPACE::map<int, int>::const_iterator it = scanTest.begin(); it != end; ++it)
+					{
+						unsigned long	x = it->second;
+						for (int k = 0; k < work; ++k)
+							x = x * 2654435761u + it->first;
+						checksum += x;
+					}
+				}
+				LOG("scanTest.size(): " << scanTest.size() << " multiplications: " << work << " checksum: " << checksum);
+				LOG("Time taken: " << static_cast<double>((std::clock() - begin)) / CLOCKS_PER_SEC << " seconds");
+			}
+		}
+
+		LOG("100.000 lookups of 64 keys at once on 1.000.000 elements");
+		{
+			TESTED_NAMESPACE::map<int, int> batchTest;
+			for (int i = 0; i < 1000000; ++i)
+				batchTest.insert(TESTED_NAMESPACE::make_pair(std::rand(), i));
+			std::vector<int> keys(64);
+			std::vector<TESTED_NAMESPACE::map<int, int>::iterator> found(64);
+			long	checksum = 0;
+			begin = std::clock();
+			for (int i = 0; i < 100000; ++i)
+			{
+				for (size_t k = 0; k < keys.size(); ++k)
+					keys[k] = std::rand();
+				#ifndef STDSTL
+					batchTest.find_many(keys.begin(), keys.end(), found.begin());
+				#else
+					for (size_t k = 0; k < keys.size(); ++k)
+						found[k] = batchTest.find(keys[k]);
+				#endif
+				for (size_t k = 0; k < found.size(); ++k)
+					if (found[k] != batchTest.end())
+						checksum += found[k]->second;
+			}
+			LOG("batchTest.size(): " << batchTest.size() << " checksum: " << checksum);
+			LOG("Time taken: " << static_cast<double>((std::clock() - begin)) / CLOCKS_PER_SEC << " seconds");
+		}
+
+		LOG("5.000.000 find queries on a 1.000.000 element map that is no longer modified");
+		{
+			TESTED_NAMESPACE::map<int, int> buildTest;
+			for (int i = 0; i < 1000000; ++i)
+				buildTest.insert(TESTED_NAMESPACE::make_pair(std::rand(), i));
+			#ifndef STDSTL
+				ft::frozen_map<int, int> readTest(buildTest);
+			#else
+				const std::map<int, int> &readTest = buildTest;
+			#endif
+			long	checksum = 0;
+			begin = std::clock();
+			for (int i = 0; i < 5000000; ++i)
+			{
+				int	key = std::rand();
+				if (readTest.find(key) != readTest.end())
+					checksum += readTest.find(key)->second;
+			}
+			LOG("readTest.size(): " << readTest.size() << " checksum: " << checksum);
+			LOG("Time taken: " << static_cast<double>((std::clock() - begin)) / CLOCKS_PER_SEC << " seconds");
+		}
+
+		LOG("Merge a sorted stream of 2.000.000 keys into a 1.000.000 element map");
+		{
+			TESTED_NAMESPACE::map<int, int> mergeTest;
+			for (int i = 0; i < 1000000; ++i)
+				mergeTest.insert(TESTED_NAMESPACE::make_pair(std::rand() % 8000000, i));
+			begin = std::clock();
+			#ifndef STDSTL
+				TESTED_NAMESPACE::map<int, int>::cursor	cursor = mergeTest.make_cursor();
+			#endif
+			for (int key = 0, i = 0; i < 2000000; ++i)
+			{
+				key += 1 + std::rand() % 7;
+				#ifndef STDSTL
+					cursor.insert_near(TESTED_NAMESPACE::make_pair(key, i));
+				#else
+					mergeTest.insert(TESTED_NAMESPACE::make_pair(key, i));
+				#endif
+			}
+			LOG("mergeTest.size(): " << mergeTest.size());
+			LOG("Time taken: " << static_cast<double>((std::clock() - begin)) / CLOCKS_PER_SEC << " seconds");
+		}
+
+		LOG("1.000.000 string find queries on 100.000 elements");
+		{
+			TESTED_NAMESPACE::map<std::string, int, counting_less> stringTest;
+			std::vector<std::string> keys;
+			for (int i = 0; i < 200000; ++i)
+				keys.push_back("key_" + std::to_string(std::rand() % 1000000));
+			for (int i = 0; i < 100000; ++i)
+				stringTest.insert(TESTED_NAMESPACE::make_pair(keys[i], i));
+			long	checksum = 0;
+			g_compare_calls = 0;
+			begin = std::clock();
+			for (int i = 0; i < 1000000; ++i)
+			{
+				TESTED_NAMESPACE::map<std::string, int, counting_less>::iterator it = stringTest.find(keys[std::rand() % keys.size()]);
+				if (it != stringTest.end())
+					checksum += it->second;
+			}
+			LOG("stringTest.size(): " << stringTest.size() << " checksum: " << checksum);
+			// differs between the ft and the std build, so it stays out of the diffed output
+			std::cerr << "comparator calls: " << g_compare_calls << std::endl;
+			LOG("Time taken: " << static_cast<double>((std::clock() - begin)) / CLOCKS_PER_SEC << " seconds");
+		}
+
+		LOG("1.000.000 lower_bound/upper_bound/equal_range queries");
+		for (size_t n = 1000; n <= 10000000; n *= 10)
+		{
+			TESTED_NAMESPACE::map<int, int> rangeTest;
+			for (size_t i = 0; i < n; ++i)
+				rangeTest.insert(TESTED_NAMESPACE::make_pair<int, int>(std::rand(), i));
+			long	checksum = 0;
+			begin = std::clock();
+			for (size_t i = 0; i < 1000000; ++i)
+			{
+				int	key = std::rand();
+				TESTED_NAMESPACE::map<int, int>::iterator lower = rangeTest.lower_bound(key);
+				TESTED_NAMESPACE::map<int, int>::iterator upper = rangeTest.upper_bound(key);
+				TESTED_NAMESPACE::pair<TESTED_NAMESPACE::map<int, int>::iterator,
+					TESTED_NAMESPACE::map<int, int>::iterator> range = rangeTest.equal_range(key);
+				if (lower != rangeTest.end())
+					checksum += lower->second;
+				if (upper != rangeTest.end())
+					checksum += upper->second;
+				checksum += (range.first == range.second);
+			}
+			LOG("rangeTest.size(): " << rangeTest.size() << " checksum: " << checksum);
+			LOG("Time taken: " << static_cast<double>((std::clock() - begin)) / CLOCKS_PER_SEC << " seconds");
+		}
+
+		LOG("Insert 10.000.000 sorted pairs with hint end()");
+		begin = std::clock();
+		{
+			TESTED_NAMESPACE::map<int, int> hintTest;
+			for (int i = 0; i < 10000000; ++i)
+				hintTest.insert(hintTest.end(), TESTED_NAMESPACE::make_pair(i, i));
+			LOG("hintTest.size(): " << hintTest.size());
+		}
+		LOG("Time taken: " << static_cast<double>((std::clock() - begin)) / CLOCKS_PER_SEC << " seconds");
+
+		LOG("Range construct from 10.000.000 sorted pairs");
+		{
+			TESTED_NAMESPACE::vector<TESTED_NAMESPACE::pair<int, int> > sorted;
+			for (int i = 0; i < 10000000; ++i)
+				sorted.push_back(TESTED_NAMESPACE::make_pair(i, i));
+			begin = std::clock();
+			TESTED_NAMESPACE::map<int, int> buildTest(sorted.begin(), sorted.end());
+			LOG("buildTest.size(): " << buildTest.size());
+			LOG("Time taken: " << static_cast<double>((std::clock() - begin)) / CLOCKS_PER_SEC << " seconds");
+		}
+
+		LOG("Insert/erase churn, 10.000.000 rounds, std::allocator");
+		begin = std::clock();
+		{
+			TESTED_NAMESPACE::map<int, int> churnTest;
+			for (int i = 0; i < 100000; ++i)
+				churnTest.insert(TESTED_NAMESPACE::make_pair(std::rand() % 200000, i));
+			for (int i = 0; i < 10000000; ++i)
+			{
+				churnTest.erase(std::rand() % 200000);
+				churnTest.insert(TESTED_NAMESPACE::make_pair(std::rand() % 200000, i));
+			}
+			LOG("churnTest.size(): " << churnTest.size());
+		}
+		LOG("Time taken: " << static_cast<double>((std::clock() - begin)) / CLOCKS_PER_SEC << " seconds");
+
+		LOG("Insert/erase churn, 10.000.000 rounds, ft::pool_allocator");
+		begin = std::clock();
+		{
+			TESTED_NAMESPACE::map<int, int, std::less<int>,
+				ft::pool_allocator<TESTED_NAMESPACE::pair<const int, int> > > churnTest;
+			#ifndef STDSTL
+				churnTest.reserve(100000);
+			#endif
+			for (int i = 0; i < 100000; ++i)
+				churnTest.insert(TESTED_NAMESPACE::make_pair(std::rand() % 200000, i));
+			for (int i = 0; i < 10000000; ++i)
+			{
+				churnTest.erase(std::rand() % 200000);
+				churnTest.insert(TESTED_NAMESPACE::make_pair(std::rand() % 200000, i));
+			}
+			LOG("churnTest.size(): " << churnTest.size());
+		}
+		LOG("Time taken: " << static_cast<double>((std::clock() - begin)) / CLOCKS_PER_SEC << " seconds");
+
+		LOG("Split and rejoin a 100.000 element map 100 times");
+		{
+			TESTED_NAMESPACE::map<int, int> splitTest;
+			for (int i = 0; i < 100000; ++i)
+				splitTest.insert(splitTest.end(), TESTED_NAMESPACE::make_pair(i, i));
+			long	checksum = 0;
+			begin = std::clock();
+			for (int i = 0; i < 100; ++i)
+			{
+				TESTED_NAMESPACE::map<int, int> upper;
+				int	key = std::rand() % 100000;
+				#if !defined(STDSTL) && defined(FT_ORDER_STATISTICS)
+					splitTest.split(key, upper);
+					checksum += splitTest.size();
+					splitTest.join(upper);
+				#else
+					upper.insert(splitTest.lower_bound(key), splitTest.end());
+					splitTest.erase(splitTest.lower_bound(key), splitTest.end());
+					checksum += splitTest.size();
+					splitTest.insert(upper.begin(), upper.end());
+				#endif
+			}
+			LOG("splitTest.size(): " << splitTest.size() << " checksum: " << checksum);
+			LOG("Time taken: " << static_cast<double>((std::clock() - begin)) / CLOCKS_PER_SEC << " seconds");
+		}
+
+		LOG("Move 1.000.000 entries from a staging map to a live map");
+		{
+			TESTED_NAMESPACE::map<int, std::string> staging;
+			TESTED_NAMESPACE::map<int, std::string> live;
+			for (int i = 0; i < 1000000; ++i)
+				staging.insert(TESTED_NAMESPACE::make_pair(std::rand(), "text number: " + std::to_string(i)));
+			begin = std::clock();
+			while (!staging.empty())
+			{
+				#ifndef STDSTL
+					TESTED_NAMESPACE::map<int, std::string>::node_type node = staging.extract(staging.begin());
+					live.insert(node);
+				#else
+					live.insert(*staging.begin());
+					staging.erase(staging.begin());
+				#endif
+			}
+			LOG("live.size(): " << live.size());
+			LOG("Time taken: " << static_cast<double>((std::clock() - begin)) / CLOCKS_PER_SEC << " seconds");
+		}
 	}
 	LOG("Leak check:");
 	#ifndef STDSTL
@@ -494,6 +1286,94 @@ int main(int argc, char** argv)
 			LOG("setKeyComp(3, 6): " << setKeyComp(3, 6));
 			LOG("setValueComp(*setTest3.find(0), *setTest3.find(14)): " << setValueComp.operator()(*setTest3.find(0), *setTest3.find(14)));
 			LOG("setValueComp(*setTest3.find(14), *setTest3.find(0)): " << setValueComp.operator()(*setTest3.find(14), *setTest3.find(0)));
+		// set_union, set_intersection, set_difference, set_symmetric_difference
+		{
+			TESTED_NAMESPACE::set<int> odd;
+			TESTED_NAMESPACE::set<int> low;
+			TESTED_NAMESPACE::set<int> big;
+			TESTED_NAMESPACE::set<int> empty;
+			for (int i = 1; i < 12; i += 2)
+				odd.insert(i);
+			for (int i = 0; i < 6; ++i)
+				low.insert(i);
+			for (int i = 0; i < 300; i += 3)
+				big.insert(i);
+			// the small side is looked up in the big one
+			TESTED_NAMESPACE::set<int> *lhs[] = { &odd, &low, &odd, &empty, &empty, &odd, &big };
+			TESTED_NAMESPACE::set<int> *rhs[] = { &low, &odd, &empty, &odd, &empty, &big, &odd };
+			for (size_t k = 0; k < sizeof(lhs) / sizeof(*lhs); ++k)
+			{
+				TESTED_NAMESPACE::set<int> result[4];
+				for (size_t r = 0; r < 4; ++r)
+					result[r].insert(-1);
+				#ifndef STDSTL
+					lhs[k]->set_union(*rhs[k], result[0]);
+					lhs[k]->set_intersection(*rhs[k], result[1]);
+					lhs[k]->set_difference(*rhs[k], result[2]);
+					lhs[k]->set_symmetric_difference(*rhs[k], result[3]);
+				#else
+					for (size_t r = 0; r < 4; ++r)
+						result[r].clear();
+					std::set_union(lhs[k]->begin(), lhs[k]->end(), rhs[k]->begin(), rhs[k]->end(),
+						std::inserter(result[0], result[0].end()));
+					std::set_intersection(lhs[k]->begin(), lhs[k]->end(), rhs[k]->begin(), rhs[k]->end(),
+						std::inserter(result[1], result[1].end()));
+					std::set_difference(lhs[k]->begin(), lhs[k]->end(), rhs[k]->begin(), rhs[k]->end(),
+						std::inserter(result[2], result[2].end()));
+					std::set_symmetric_difference(lhs[k]->begin(), lhs[k]->end(), rhs[k]->begin(), rhs[k]->end(),
+						std::inserter(result[3], result[3].end()));
+				#endif
+				if (lhs[k]->size() + rhs[k]->size() < 50)
+				{
+					LOG("lhs: " << *lhs[k] << "| rhs: " << *rhs[k]);
+					LOG("union: " << result[0] << "| intersection: " << result[1]);
+					LOG("difference: " << result[2] << "| symmetric difference: " << result[3]);
+				}
+				else
+					LOG("with big: intersection: " << result[1] << "| difference size: " << result[2].size()
+						<< " union size: " << result[0].size() << " symmetric difference size: " << result[3].size());
+			}
+			TESTED_NAMESPACE::set<int> self(odd);
+			TESTED_NAMESPACE::set<int> other(low);
+			#ifndef STDSTL
+				self.set_union(low, self);
+				LOG("self.set_union(low, self): " << self);
+				self.set_intersection(odd, self);
+				LOG("self.set_intersection(odd, self): " << self);
+				odd.set_difference(other, other);
+				LOG("odd.set_difference(other, other): " << other);
+				low.set_symmetric_difference(other, other);
+				LOG("low.set_symmetric_difference(other, other): " << other);
+			#else
+				TESTED_NAMESPACE::set<int> tmp;
+				std::set_union(self.begin(), self.end(), low.begin(), low.end(), std::inserter(tmp, tmp.end()));
+				self.swap(tmp);
+				LOG("self.set_union(low, self): " << self);
+				tmp.clear();
+				std::set_intersection(self.begin(), self.end(), odd.begin(), odd.end(), std::inserter(tmp, tmp.end()));
+				self.swap(tmp);
+				LOG("self.set_intersection(odd, self): " << self);
+				tmp.clear();
+				std::set_difference(odd.begin(), odd.end(), other.begin(), other.end(), std::inserter(tmp, tmp.end()));
+				other.swap(tmp);
+				LOG("odd.set_difference(other, other): " << other);
+				tmp.clear();
+				std::set_symmetric_difference(low.begin(), low.end(), other.begin(), other.end(), std::inserter(tmp, tmp.end()));
+				other.swap(tmp);
+				LOG("low.set_symmetric_difference(other, other): " << other);
+			#endif
+			// a few elements into a much larger set are merged into it in place
+			#ifndef STDSTL
+				big.set_union(odd, big);
+				big.set_symmetric_difference(low, big);
+			#else
+				big.insert(odd.begin(), odd.end());
+				for (TESTED_NAMESPACE::set<int>::iterator it = low.begin(); it != low.end(); ++it)
+					if (!big.erase(*it))
+						big.insert(*it);
+			#endif
+			LOG("big.set_union(odd, big), big.set_symmetric_difference(low, big): " << big);
+		}
 	// Performance test
 		LOG("Insert 10.000.000 pairs without hint");
 		clock_t begin = std::clock();
@@ -523,6 +1403,38 @@ int main(int argc, char** argv)
 		for (size_t i = 0; i < 10000000; ++i)
 			setTest.erase(std::rand() % 10000000);
 		LOG("setTest.size(): " << setTest.size());
+
+		LOG("Intersection and union of 1.000.000 and 1.000.000 / 1.000 random elements");
+		{
+			TESTED_NAMESPACE::set<int> big;
+			TESTED_NAMESPACE::set<int> similar;
+			TESTED_NAMESPACE::set<int> small;
+			for (int i = 0; i < 1000000; ++i)
+			{
+				big.insert(std::rand() % 2000000);
+				similar.insert(std::rand() % 2000000);
+			}
+			for (int i = 0; i < 1000; ++i)
+				small.insert(std::rand() % 2000000);
+			const TESTED_NAMESPACE::set<int>	*others[2] = { &similar, &small };
+			for (int i = 0; i < 2; ++i)
+			{
+				TESTED_NAMESPACE::set<int> intersection;
+				TESTED_NAMESPACE::set<int> setUnion;
+				begin = std::clock();
+				#ifndef STDSTL
+					big.set_intersection(*others[i], intersection);
+					big.set_union(*others[i], setUnion);
+				#else
+					std::set_intersection(big.begin(), big.end(), others[i]->begin(), others[i]->end(),
+						std::inserter(intersection, intersection.end()));
+					std::set_union(big.begin(), big.end(), others[i]->begin(), others[i]->end(),
+						std::inserter(setUnion, setUnion.end()));
+				#endif
+				LOG("intersection.size(): " << intersection.size() << " setUnion.size(): " << setUnion.size());
+				LOG("Time taken: " << static_cast<double>((std::clock() - begin)) / CLOCKS_PER_SEC << " seconds");
+			}
+		}
 	}
 	LOG("Leak check:");
 	#ifndef STDSTL
@@ -12,6 +12,7 @@
 #endif
 
 #include <iostream>
+#include <string>
 #include <limits.h>
 #include <stdlib.h>
 #include <math.h>
@@ -420,6 +421,19 @@ int	main(void)
 		rb++;
 	}
 
+// insert of an element of the vector itself: strings are swapped, not copied,
+// when the tail is shifted in C++98
+	vector<std::string>	words;
+	words.push_back("first");
+	words.push_back("second");
+	words.push_back("third");
+	words.reserve(20);
+	words.insert(words.begin(), words[0]);
+	words.insert(words.begin() + 1, 3, words[3]);
+	words.insert(words.begin() + 2, words.size() * 2, words[6]);
+	for (size_t i = 0; i < words.size(); i++)
+		cout << words[i] << (i + 1 < words.size() ? ", " : "\n");
+
 // TESTS STACK, SET, MAP
 
 	ft::stack<int>	stack_test;
@@ -0,0 +1,78 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Compare.hpp                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mstrantz <mstrantz@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 17:21:40 by mstrantz          #+#    #+#             */
+/*   Updated: 2026/10/18 17:21:40 by mstrantz         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef COMPARE_HPP
+# define COMPARE_HPP
+
+// Three-way comparison hook
+//  The tree orders elements with a "less" comparator, which takes two calls to
+//  tell equal elements apart. Specializing three_way_compare for a comparator
+//  lets lookups get less / equal / greater out of a single call:
+//
+//      template <>
+//          struct three_way_compare<my_less> {
+//              static const bool value = true;
+//              static int compare(my_less const &cmp, A const &a, B const &b);
+//          };
+//
+//  compare returns a negative value, 0 or a positive value like strcmp, and has
+//  to agree with the comparator. It is provided for std::less over std::string.
+//
+// Arithmetic keys
+//  is_arithmetic_less tells if a comparator is std::less over an arithmetic
+//  type. Such a comparison is a single cheap instruction, so the tree descends
+//  without branches: the result of the comparison indexes the child to go to.
+
+# include <functional>
+# include <string>
+# include "TypeTraits.hpp"
+
+namespace ft {
+
+template <class Compare>
+    struct three_way_compare {
+        static const bool value = false;
+    };
+
+template <class C, class Tr, class A>
+    struct three_way_compare<std::less<std::basic_string<C, Tr, A> > > {
+        static const bool value = true;
+
+        static int compare(std::less<std::basic_string<C, Tr, A> > const &,
+                           std::basic_string<C, Tr, A> const &a, std::basic_string<C, Tr, A> const &b) {
+            return (a.compare(b));
+        }
+    };
+
+// the default comparator of ft::map is std::less<const Key>
+template <class C, class Tr, class A>
+    struct three_way_compare<std::less<const std::basic_string<C, Tr, A> > > {
+        static const bool value = true;
+
+        static int compare(std::less<const std::basic_string<C, Tr, A> > const &,
+                           std::basic_string<C, Tr, A> const &a, std::basic_string<C, Tr, A> const &b) {
+            return (a.compare(b));
+        }
+    };
+
+template <class Compare>
+    struct is_arithmetic_less : public false_type { };
+
+template <class T>
+    struct is_arithmetic_less<std::less<T> > : public is_arithmetic<T> { };
+
+template <class T>
+    struct is_arithmetic_less<std::less<const T> > : public is_arithmetic<T> { };
+
+} // namespace ft
+
+#endif // COMPARE_HPP
@@ -0,0 +1,160 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   NodeHandle.hpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mstrantz <mstrantz@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 15:04:12 by mstrantz          #+#    #+#             */
+/*   Updated: 2026/10/18 15:04:12 by mstrantz         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef NODEHANDLE_HPP
+# define NODEHANDLE_HPP
+
+// Node handle
+//  Owns a tree node that was extracted from a map or set, so the element can be
+//  inserted into another container without being copied or reallocated.
+//
+//  There is no move in C++98, so like std::auto_ptr a copy takes the node away
+//  from the handle it was copied from. Copies and inserts take non-const
+//  handles only, a temporary such as the result of extract() gets there through
+//  node_handle_ref like an auto_ptr through auto_ptr_ref, so a const handle can
+//  not lose its node. The handle keeps copies of the allocators of the tree it
+//  came from and frees the node with them if it still owns one when it is
+//  destroyed.
+
+# include <cstddef>
+
+namespace ft {
+
+template <class T, class Compare, class Alloc, class Key>
+    class RB_BST;
+
+template <class Node, class Alloc, class NodeAlloc>
+    class node_handle;
+
+// a temporary handle converts to this to be copied or inserted
+template <class Node, class Alloc, class NodeAlloc>
+    struct node_handle_ref {
+        node_handle<Node, Alloc, NodeAlloc>  &handle;
+
+        explicit node_handle_ref(node_handle<Node, Alloc, NodeAlloc> &h) : handle(h) { }
+    };
+
+template <class Node, class Alloc, class NodeAlloc>
+    class node_handle {
+
+        public:
+            typedef typename Node::value_type   value_type;
+            typedef Alloc                       allocator_type;
+
+        private:
+            typedef node_handle_ref<Node, Alloc, NodeAlloc> _ref_type;
+
+            Node            *_node;
+            allocator_type  _alloc;
+            NodeAlloc       _node_alloc;
+
+            void    _reset() {
+                if (_node == NULL)
+                    return ;
+                _alloc.destroy(&(_node->data));
+                _node_alloc.deallocate(_node, 1);
+                _node = NULL;
+            }
+
+            void    _take(node_handle &other) {
+                if (this == &other)
+                    return ;
+                _reset();
+                _node = other._node;
+                _alloc = other._alloc;
+                _node_alloc = other._node_alloc;
+                other._node = NULL;
+            }
+
+            template <class T, class Compare, class A, class Key>
+                friend class RB_BST;
+
+        public:
+            node_handle() : _node(NULL), _alloc(), _node_alloc() { }
+
+            node_handle(Node *node, allocator_type const &alloc, NodeAlloc const &node_alloc)
+                : _node(node), _alloc(alloc), _node_alloc(node_alloc) { }
+
+            node_handle(node_handle &other)
+                : _node(other._node), _alloc(other._alloc), _node_alloc(other._node_alloc) {
+                other._node = NULL;
+            }
+
+            node_handle(_ref_type ref)
+                : _node(ref.handle._node), _alloc(ref.handle._alloc), _node_alloc(ref.handle._node_alloc) {
+                ref.handle._node = NULL;
+            }
+
+            ~node_handle() {
+                _reset();
+            }
+
+            node_handle &operator=(node_handle &rhs) {
+                _take(rhs);
+                return (*this);
+            }
+
+            node_handle &operator=(_ref_type ref) {
+                _take(ref.handle);
+                return (*this);
+            }
+
+            operator _ref_type() { return (_ref_type(*this)); }
+
+            bool            empty() const { return (_node == NULL); }
+            value_type      &value() const { return (_node->data); }
+            allocator_type  get_allocator() const { return (_alloc); }
+
+            void    swap(node_handle &other) {
+                Node        *tmp_node = _node;
+                _node = other._node;
+                other._node = tmp_node;
+                allocator_type  tmp_alloc = _alloc;
+                _alloc = other._alloc;
+                other._alloc = tmp_alloc;
+                NodeAlloc   tmp_node_alloc = _node_alloc;
+                _node_alloc = other._node_alloc;
+                other._node_alloc = tmp_node_alloc;
+            }
+    };
+
+// the handle of ft::map, which also gives access to key and mapped value
+template <class Node, class Alloc, class NodeAlloc>
+    class map_node_handle : public node_handle<Node, Alloc, NodeAlloc> {
+
+        public:
+            typedef node_handle<Node, Alloc, NodeAlloc>         base_type;
+            typedef node_handle_ref<Node, Alloc, NodeAlloc>     ref_type;
+            typedef typename base_type::value_type::first_type  key_type;
+            typedef typename base_type::value_type::second_type mapped_type;
+
+            map_node_handle() { }
+            map_node_handle(map_node_handle &other) : base_type(other) { }
+            map_node_handle(ref_type ref) : base_type(ref) { }
+
+            map_node_handle &operator=(map_node_handle &rhs) {
+                base_type::operator=(rhs);
+                return (*this);
+            }
+
+            map_node_handle &operator=(ref_type ref) {
+                base_type::operator=(ref);
+                return (*this);
+            }
+
+            key_type const  &key() const { return (this->value().first); }
+            mapped_type     &mapped() const { return (this->value().second); }
+    };
+
+} // namespace ft
+
+#endif // NODEHANDLE_HPP
@@ -13,6 +13,12 @@
 #ifndef PAIR_HPP
 # define PAIR_HPP
 
+# include "TypeTraits.hpp"
+# ifdef FT_CXX11
+#  include <type_traits>
+#  include <utility>
+# endif
+
 namespace ft {
 
 template <class T1, class T2>
@@ -35,6 +41,24 @@ struct pair
 		second = p.second;
 		return (*this);
 	}
+
+# ifdef FT_CXX11
+	pair(pair const &) = default;
+	pair(pair &&) = default;
+
+	template<class U1, class U2, class = typename std::enable_if<
+		std::is_constructible<T1, U1 &&>::value && std::is_constructible<T2, U2 &&>::value>::type>
+	pair(U1 &&u1, U2 &&u2) : first(std::forward<U1>(u1)), second(std::forward<U2>(u2)) { }
+
+	template<class U1, class U2>
+	pair(pair<U1, U2> &&p) : first(std::forward<U1>(p.first)), second(std::forward<U2>(p.second)) { }
+
+	pair	&operator=(pair &&p) {
+		first = std::move(p.first);
+		second = std::move(p.second);
+		return (*this);
+	}
+# endif
 };
 
 template <class T1, class T2>
@@ -69,7 +93,11 @@ template <class T1, class T2>
 
 template <class T1, class T2>
 	pair<T1, T2> make_pair(T1 x, T2 y) {
+# ifdef FT_CXX11
+		return (pair<T1, T2>(std::move(x), std::move(y)));
+# else
 		return (pair<T1, T2>(x, y));
+# endif
 	}
 
 } // ft
@@ -0,0 +1,222 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   PoolAllocator.hpp                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mstrantz <mstrantz@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 10:12:31 by mstrantz          #+#    #+#             */
+/*   Updated: 2026/10/18 10:12:31 by mstrantz         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef POOLALLOCATOR_HPP
+# define POOLALLOCATOR_HPP
+
+// Pool allocator for node based containers
+//  Single objects are carved out of large chunks and recycled through a free list,
+//  so insert/erase churn does not go through malloc for every node.
+//  Requests for more than one object are forwarded to ::operator new.
+//
+//  Copies of an allocator share one pool (reference counted), so a container and
+//  the allocators it hands out can free each others blocks. Rebinding creates a
+//  new pool, since the block size changes: ft::map and ft::set rebind the
+//  allocator they are given to their node type, so their nodes come from a pool
+//  of their own and the pool of the given allocator stays empty (no chunk is
+//  allocated before the first allocation). The reference count is not atomic,
+//  so a copied container starts a pool of its own
+//  (select_on_container_copy_construction) and an assigned one keeps its pool:
+//  containers only share a pool when nodes move between them (split, extract).
+//  Chunks are only given back when the last allocator sharing the pool is
+//  destroyed.
+//
+//  Compile with -D FT_POOL_ALLOCATOR to make it the default allocator of ft::map and ft::set.
+
+# include <cstddef>
+# include <new>
+# include <memory>
+
+namespace ft {
+
+template <class T>
+    class pool_allocator {
+
+        public:
+            typedef T                   value_type;
+            typedef T*                  pointer;
+            typedef const T*            const_pointer;
+            typedef T&                  reference;
+            typedef const T&            const_reference;
+            typedef size_t              size_type;
+            typedef ptrdiff_t           difference_type;
+
+            template <class U>
+                struct rebind {
+                    typedef pool_allocator<U> other;
+                };
+
+        private:
+            // a free block stores the link to the next one, the other members
+            // only make sure blocks are big and aligned enough for any T
+            union _block {
+                _block      *next;
+                char        storage[sizeof(T)];
+                long double ld;
+                long long   ll;
+                void        *p;
+            };
+
+            union _chunk {
+                _chunk      *next;
+                long double ld;
+            };
+
+            struct _pool {
+                _block      *free;
+                _chunk      *chunks;
+                size_type   next_chunk;
+                size_type   refs;
+            };
+
+            static const size_type  _min_chunk = 64;
+            static const size_type  _max_chunk = 65536;
+
+            _pool   *_p;
+
+            void    _grow(size_type n) {
+                char    *raw = static_cast<char *>(::operator new(sizeof(_chunk) + n * sizeof(_block)));
+                _chunk  *chunk = reinterpret_cast<_chunk *>(raw);
+                _block  *blocks = reinterpret_cast<_block *>(raw + sizeof(_chunk));
+
+                chunk->next = _p->chunks;
+                _p->chunks = chunk;
+                for (size_type i = n; i > 0; --i) {
+                    blocks[i - 1].next = _p->free;
+                    _p->free = &blocks[i - 1];
+                }
+            }
+
+            void    _release() {
+                if (--_p->refs != 0)
+                    return ;
+                while (_p->chunks) {
+                    _chunk  *next = _p->chunks->next;
+                    ::operator delete(_p->chunks);
+                    _p->chunks = next;
+                }
+                delete _p;
+            }
+
+            static _pool    *_new_pool() {
+                _pool   *p = new _pool;
+                p->free = NULL;
+                p->chunks = NULL;
+                p->next_chunk = _min_chunk;
+                p->refs = 1;
+                return (p);
+            }
+
+        public:
+            pool_allocator() : _p(_new_pool()) { }
+
+            pool_allocator(pool_allocator const &other) : _p(other._p) {
+                ++_p->refs;
+            }
+
+            template <class U>
+                pool_allocator(pool_allocator<U> const &) : _p(_new_pool()) { }
+
+            ~pool_allocator() {
+                _release();
+            }
+
+            pool_allocator  &operator=(pool_allocator const &rhs) {
+                ++rhs._p->refs;
+                _release();
+                _p = rhs._p;
+                return (*this);
+            }
+
+            // a copy of a container gets a pool of its own
+            pool_allocator  select_on_container_copy_construction() const {
+                return (pool_allocator());
+            }
+
+            pointer         address(reference x) const { return &x; }
+            const_pointer   address(const_reference x) const { return &x; }
+
+            pointer allocate(size_type n, const void * = 0) {
+                if (n != 1)
+                    return (static_cast<pointer>(::operator new(n * sizeof(T))));
+                if (_p->free == NULL) {
+                    _grow(_p->next_chunk);
+                    if (_p->next_chunk < _max_chunk)
+                        _p->next_chunk *= 2;
+                }
+                _block  *ret = _p->free;
+                _p->free = ret->next;
+                return (reinterpret_cast<pointer>(ret));
+            }
+
+            void    deallocate(pointer p, size_type n) {
+                if (n != 1) {
+                    ::operator delete(p);
+                    return ;
+                }
+                _block  *b = reinterpret_cast<_block *>(p);
+                b->next = _p->free;
+                _p->free = b;
+            }
+
+            // makes sure the next n single object allocations don't need a new chunk
+            void    reserve(size_type n) {
+                size_type   available = 0;
+                for (_block *b = _p->free; b != NULL && available < n; b = b->next)
+                    ++available;
+                if (available < n)
+                    _grow(n - available);
+            }
+
+            // the same as std::allocator, so max_size() of the containers does not change
+            size_type   max_size() const {
+                return (std::allocator<T>().max_size());
+            }
+
+            void    construct(pointer p, const_reference val) {
+                new (static_cast<void *>(p)) T(val);
+            }
+
+            void    destroy(pointer p) {
+                p->~T();
+            }
+
+            template <class U>
+                friend class pool_allocator;
+
+            template <class U, class V>
+                friend bool operator==(pool_allocator<U> const &lhs, pool_allocator<V> const &rhs);
+    };
+
+template <class U, class V>
+    bool    operator==(pool_allocator<U> const &lhs, pool_allocator<V> const &rhs) {
+        return (static_cast<void *>(lhs._p) == static_cast<void *>(rhs._p));
+    }
+
+template <class U, class V>
+    bool    operator!=(pool_allocator<U> const &lhs, pool_allocator<V> const &rhs) {
+        return !(lhs == rhs);
+    }
+
+// allocator ft::map and ft::set use when none is given
+template <class T>
+    struct tree_default_allocator {
+# ifdef FT_POOL_ALLOCATOR
+        typedef ft::pool_allocator<T>   type;
+# else
+        typedef std::allocator<T>       type;
+# endif
+    };
+
+} // namespace ft
+
+#endif // POOLALLOCATOR_HPP
@@ -70,21 +70,31 @@
 # include "../utils/Pair.hpp"
 # include "../utils/Utils.hpp"
 # include "TreeNode.hpp"
+# include "PoolAllocator.hpp"
+# include "NodeHandle.hpp"
+# include "Compare.hpp"
+# include "TypeTraits.hpp"
 # include <functional>
 # include <iostream>
+# include <stdexcept>
 # include "../iterators/bst_bidirectional_iterator.hpp"
 # include "../iterators/reverse_iterator.hpp"
 
 namespace ft {
 
+// Key is the type lookups and erase by key are done with. When it differs
+// from T, Compare has to accept (T, Key) and (Key, T) in addition to (T, T),
+// so that a lookup never has to build a whole value_type.
 template < class T,
            class Compare = std::less<T>,
-           class Alloc = std::allocator<T>
+           class Alloc = std::allocator<T>,
+           class Key = T
          >
     class RB_BST {
 
         public:
             typedef T                                                                   value_type;
+            typedef Key                                                                 key_type;
             typedef Compare                                                             value_compare;
             typedef Alloc                                                               allocator_type;
             typedef typename Alloc::template rebind<tree_node<value_type> >::other      node_allocator_type;
@@ -94,36 +104,128 @@ template < class T,
             typedef ft::reverse_iterator<iterator>                                      reverse_iterator;
             typedef ft::reverse_iterator<const_iterator>                                const_reverse_iterator;
             typedef size_t                                                              size_type;
+            typedef ft::node_handle<Node, allocator_type, node_allocator_type>         node_type;
+            typedef ft::node_handle_ref<Node, allocator_type, node_allocator_type>     node_ref_type;
 
         private:
+            // _parent is the header node that serves as end(). Its left link is the
+            // root (or the header itself when the tree is empty), its right link
+            // the last node (NULL when empty), so iterators step back from end()
+            // in O(1). _leftmost caches the first node, or the header when empty.
             Node                _parent;
             Node                *_root;
+            Node                *_leftmost;
             allocator_type      _alloc;
             node_allocator_type _node_alloc;
             value_compare       _cmp;
             size_type           _size;
 
+            // a new node is a red leaf
+            Node    *_init_node(Node *node) {
+                node->set_parent(NULL);
+                node->left = NULL;
+                node->right = NULL;
+                node->set_color(RED);
+# ifdef FT_ORDER_STATISTICS
+                node->size = 1;
+# endif
+                return (node);
+            }
+
             Node    *_createNode(value_type const &val) {
                 Node    *ret = _node_alloc.allocate(1);
                 _alloc.construct(&(ret->data), val);
-                ret->parent = NULL;
-                ret->left = NULL;
-                ret->right = NULL;
-                ret->color = RED;
-                return (ret);
+                return (_init_node(ret));
             }
 
+# ifdef FT_CXX11
+            template <class... Args>
+                Node    *_createNode(Args&&... args) {
+                    Node    *ret = _node_alloc.allocate(1);
+                    new (static_cast<void *>(&(ret->data))) value_type(std::forward<Args>(args)...);
+                    return (_init_node(ret));
+                }
+# endif
+
             void    _removeNode(Node *root) {
                 _alloc.destroy(&(root->data));
                 _node_alloc.deallocate(root, 1);
             }
 
+            // only pooled allocators can hold nodes in advance
+            template <class A>
+                static void _reserve_nodes(A &, size_type) { }
+
+            template <class U>
+                static void _reserve_nodes(ft::pool_allocator<U> &alloc, size_type n) {
+                    alloc.reserve(n);
+                }
+
+            // a copied or assigned tree does not share the pool of its source
+            template <class A>
+                static A    _copy_alloc(A const &alloc) { return (alloc); }
+
+            template <class U>
+                static ft::pool_allocator<U>    _copy_alloc(ft::pool_allocator<U> const &alloc) {
+                    return (alloc.select_on_container_copy_construction());
+                }
+
+            template <class A>
+                static void _assign_alloc(A &alloc, A const &src) { alloc = src; }
+
+            template <class U>
+                static void _assign_alloc(ft::pool_allocator<U> &, ft::pool_allocator<U> const &) { }
+
+            // the standard allocators are asked about the default node layout
+            template <class A>
+                static size_type    _max_nodes(A const &alloc) { return (alloc.max_size()); }
+
+            template <class U>
+                static size_type    _max_nodes(std::allocator<U> const &) {
+                    return (std::allocator<tree_node_plain<value_type> >().max_size());
+                }
+
+            template <class U>
+                static size_type    _max_nodes(ft::pool_allocator<U> const &) {
+                    return (std::allocator<tree_node_plain<value_type> >().max_size());
+                }
+
+            // recomputes the subtree size of node from its children
+            void    _update(Node *node) {
+# ifdef FT_ORDER_STATISTICS
+                node->size = 1 + tree_subtree_size(node->left) + tree_subtree_size(node->right);
+# else
+                (void)node;
+# endif
+            }
+
+            // recomputes the subtree sizes from node up to the root
+            void    _update_path(Node *node) {
+# ifdef FT_ORDER_STATISTICS
+                for (; node != &_parent; node = node->get_parent())
+                    _update(node);
+# else
+                (void)node;
+# endif
+            }
+
+            // frees the subtree of node without recursion or a stack: left children
+            // are rotated up until node has none, then node is freed and its right
+            // subtree is next. Every node is rotated at most once, so this is O(n)
             void    _clear(Node *node) {
-                if (node == NULL)
-                    return ;
-                _clear(node->left);
-                _clear(node->right);
-                _removeNode(node);
+                while (node != NULL) {
+                    if (node->left != NULL) {
+                        Node    *left = node->left;
+                        node->left = left->right;
+                        left->right = node;
+                        node = left;
+                    }
+                    else {
+                        Node    *next = node->right;
+                        _removeNode(node);
+                        node = next;
+                    }
+                }
             }
             /* template <class _Tp>
             struct less : binary_function<_Tp, _Tp, bool>
@@ -131,25 +233,220 @@ template < class T,
                 bool operator()(const _Tp& __x, const _Tp& __y) const
                     {return __x < __y;}
             }; */
-            bool    _equals(value_type const &first, value_type const &second) const {
-                return (!_cmp(first, second) && !_cmp(second, first));
+            typedef ft::integral_constant<bool, ft::three_way_compare<Compare>::value>  _three_way;
+            typedef ft::integral_constant<bool, ft::is_arithmetic_less<Compare>::value> _branchless;
+
+            // with -D FT_PREFETCH the next level is requested from memory while
+            // node is being compared, whichever way the descent goes
+            static void _prefetch_children(Node const *node) {
+# ifdef FT_PREFETCH
+                tree_prefetch(node->left);
+                tree_prefetch(node->right);
+# else
+                (void)node;
+# endif
+            }
+
+            // requests node from memory, used where independent descents are
+            // interleaved, so it does not depend on -D FT_PREFETCH
+            static void _prefetch_node(Node const *node) {
+# if defined(__GNUC__) || defined(__clang__)
+                __builtin_prefetch(node);
+# else
+                (void)node;
+# endif
+            }
+
+            // Moves node one level down: to its right child if right is set,
+            // otherwise to its left child, and node becomes the new bound.
+            // For arithmetic keys both choices are made by indexing with the
+            // comparison result, so a descent on random keys has no branch to
+            // mispredict on every level.
+            static void _descend(Node *&node, Node *&bound, bool right) {
+                _descend(node, bound, right, _branchless());
             }
 
-            // Node *root must be the root of the BST you want to search the key for.
-            Node    *_searchTreeHelper(Node *root, value_type const &key) const {
-                if (root == NULL || _equals(root->data, key)) {
-                    return root;
+            static void _descend(Node *&node, Node *&bound, bool right, ft::false_type) {
+                if (right)
+                    node = node->right;
+                else {
+                    bound = node;
+                    node = node->left;
                 }
-                if (_cmp(key, root->data) && root->left == NULL) {
-				    return root;
-			    }
-			    if (!_cmp(key, root->data) && root->right == NULL) {
-				    return root;
-			    }
-                if (_cmp(key, root->data)) {
-                    return (_searchTreeHelper(root->left, key));
+            }
+
+            static void _descend(Node *&node, Node *&bound, bool right, ft::true_type) {
+                Node    *const  child[2] = { node->left, node->right };
+                Node    *const  keep[2] = { node, bound };
+
+                bound = keep[right];
+                node = child[right];
+            }
+
+            // Returns the node equal to key, or NULL.
+            // With a plain "less" comparator the descent makes one call per level:
+            // it keeps the last node that is not less than key, and only that one
+            // is checked for equality at the end.
+            template <class K>
+            Node    *_find(K const &key) const {
+                return (_find(key, _three_way()));
+            }
+
+            template <class K>
+            Node    *_find(K const &key, ft::false_type) const {
+                Node    *cand = _lower_bound(_root, NULL, key);
+                if (cand != NULL && !_cmp(key, cand->data))
+                    return (cand);
+                return (NULL);
+            }
+
+            template <class K>
+            Node    *_find(K const &key, ft::true_type) const {
+                Node    *node = _root;
+                while (node != NULL) {
+                    _prefetch_children(node);
+                    int c = ft::three_way_compare<Compare>::compare(_cmp, key, node->data);
+                    if (c == 0)
+                        return (node);
+                    node = (c < 0 ? node->left : node->right);
+                }
+                return (NULL);
+            }
+
+            // Returns the node equal to key, or NULL. In the latter case parent is
+            // the node under which key has to be linked (NULL for an empty tree)
+            // and left tells on which side.
+            template <class K>
+            Node    *_insert_position(K const &key, Node *&parent, bool &left) const {
+                return (_insert_position(key, parent, left, _three_way()));
+            }
+
+            template <class K>
+            Node    *_insert_position(K const &key, Node *&parent, bool &left, ft::false_type) const {
+                Node    *cand = NULL;
+
+                parent = NULL;
+                left = false;
+                for (Node *node = _root; node != NULL; ) {
+                    _prefetch_children(node);
+                    parent = node;
+                    left = !_cmp(node->data, key);
+                    _descend(node, cand, !left);
+                }
+                if (cand != NULL && !_cmp(key, cand->data))
+                    return (cand);
+                return (NULL);
+            }
+
+            template <class K>
+            Node    *_insert_position(K const &key, Node *&parent, bool &left, ft::true_type) const {
+                parent = NULL;
+                left = false;
+                for (Node *node = _root; node != NULL; ) {
+                    _prefetch_children(node);
+                    int c = ft::three_way_compare<Compare>::compare(_cmp, key, node->data);
+                    if (c == 0)
+                        return (node);
+                    parent = node;
+                    left = (c < 0);
+                    node = (left ? node->left : node->right);
+                }
+                return (NULL);
+            }
+
+            /* --- Batched lookups --- */
+
+            // keys looked up side by side by _find_group
+            static const size_type  _find_group_size = 8;
+
+            // a red-black tree is never deeper than twice the log of its size
+            static const size_type  _max_depth = 2 * 8 * sizeof(size_type);
+
+            template <class InputIterator, class OutputIterator, class Result>
+            OutputIterator  _find_many(InputIterator first, InputIterator last, OutputIterator out,
+                                       Result end_it, ft::input_iterator_tag) const {
+                for (; first != last; ++first, ++out) {
+                    Node    *found = _find(*first);
+                    *out = (found != NULL ? Result(found) : end_it);
+                }
+                return (out);
+            }
+
+            template <class ForwardIterator, class OutputIterator, class Result>
+            OutputIterator  _find_many(ForwardIterator first, ForwardIterator last, OutputIterator out,
+                                       Result end_it, ft::forward_iterator_tag) const {
+                bool            sorted = true;
+                ForwardIterator prev = first;
+                ForwardIterator curr = first;
+                for (; sorted && curr != last; prev = curr++)
+                    sorted = !_cmp(*curr, *prev);
+                return (_find_group(first, last, out, end_it, sorted));
+            }
+
+            // Descends for up to _find_group_size keys in lockstep, one level of
+            // every descent per round. The descents do not depend on each other,
+            // so their cache misses overlap instead of being paid one after the
+            // other.
+            // The path of the last key of a group is kept. When the keys are
+            // sorted, the next group starts from the deepest node of that path
+            // whose subtree can still hold all of its keys, so keys close to
+            // each other do not descend from the root again.
+            template <class ForwardIterator, class OutputIterator, class Result>
+            OutputIterator  _find_group(ForwardIterator first, ForwardIterator last, OutputIterator out,
+                                        Result end_it, bool sorted) const {
+                ForwardIterator key[_find_group_size];
+                Node            *node[_find_group_size];
+                Node            *cand[_find_group_size];
+                Node            *path[_max_depth];
+                Node            *bound[_max_depth];
+                size_type       depth = 0;
+
+                while (first != last) {
+                    size_type   n = 0;
+                    for (; n < _find_group_size && first != last; ++n, ++first)
+                        key[n] = first;
+                    // bound[d] is the smallest node greater than the subtree of path[d]
+                    while (sorted && depth > 0 && bound[depth - 1] != NULL
+                            && _cmp(bound[depth - 1]->data, *key[n - 1]))
+                        --depth;
+                    Node    *start = _root;
+                    Node    *start_bound = NULL;
+                    if (sorted && depth > 0) {
+                        --depth;
+                        start = path[depth];
+                        start_bound = bound[depth];
+                    }
+                    else
+                        depth = 0;
+                    for (size_type i = 0; i < n; ++i) {
+                        node[i] = start;
+                        cand[i] = start_bound;
+                    }
+                    for (bool active = true; active; ) {
+                        active = false;
+                        for (size_type i = 0; i < n; ++i) {
+                            if (node[i] == NULL)
+                                continue ;
+                            if (i == n - 1) {
+                                path[depth] = node[i];
+                                bound[depth] = cand[i];
+                                ++depth;
+                            }
+                            _descend(node[i], cand[i], _cmp(node[i]->data, *key[i]));
+                            if (node[i] != NULL) {
+                                _prefetch_node(node[i]);
+                                active = true;
+                            }
+                        }
+                    }
+                    for (size_type i = 0; i < n; ++i, ++out) {
+                        if (cand[i] != NULL && !_cmp(*key[i], cand[i]->data))
+                            *out = Result(cand[i]);
+                        else
+                            *out = end_it;
+                    }
                 }
-                return (_searchTreeHelper(root->right, key));
+                return (out);
             }
 
             // returns node with minimum key of the BST defined by Node *root
@@ -168,17 +465,17 @@ template < class T,
                 return root;
             }
 
-            // if curr is last element, _successor will be NULL (?)
+            // if curr is last element, _successor is the header
             Node    *_successor(Node *curr) {
                 if (curr == NULL)
                     return NULL;
                 if (curr->right != NULL) {
                     return _minimum(curr->right);
                 }
-                Node    *currParent = curr->parent;
-                while (currParent != NULL && curr == currParent->right) {
+                Node    *currParent = curr->get_parent();
+                while (currParent != &_parent && curr == currParent->right) {
                     curr = currParent;
-                    currParent = currParent->parent;
+                    currParent = currParent->get_parent();
                 }
                 return currParent;
             }
@@ -190,10 +487,10 @@ template < class T,
                 if (curr->left != NULL) {
                     return _maximum(curr->left);
                 }
-                Node    *currParent = curr->parent;
+                Node    *currParent = curr->get_parent();
                 while (currParent != NULL && curr == currParent->left) {
                     curr = currParent;
-                    currParent = currParent->parent;
+                    currParent = currParent->get_parent();
                 }
                 return currParent;
             }
@@ -204,24 +501,26 @@ template < class T,
                 Node    *tmp = z->left;
                 if (z == _root) {
                     _root = tmp;
-                    _root->parent = &_parent;
+                    _root->set_parent(&_parent);
                     _parent.left = _root;
                 }
-                if (z->parent && z->parent != &_parent) {
-                    if (z->parent->left == z) {
-                        z->parent->left = tmp;
+                if (z->get_parent() && z->get_parent() != &_parent) {
+                    if (z->get_parent()->left == z) {
+                        z->get_parent()->left = tmp;
                     }
                     else {
-                        z->parent->right = tmp;
+                        z->get_parent()->right = tmp;
                     }
                 }
-                tmp->parent = z->parent;
-                z->parent = tmp;
+                tmp->set_parent(z->get_parent());
+                z->set_parent(tmp);
                 z->left = tmp->right;
                 if (z->left) {
-                    z->left->parent = z;
+                    z->left->set_parent(z);
                 }
                 tmp->right = z;
+                _update(z);
+                _update(tmp);
             }
 
             void    _rotate_left(Node *x) {
@@ -230,65 +529,67 @@ template < class T,
                 Node    *tmp = x->right;
                 if (x == _root) {
                     _root = tmp;
-                    _root->parent = &_parent;
+                    _root->set_parent(&_parent);
                     _parent.left = _root;
                 }
-                if (x->parent && x->parent != &_parent) {
-                    if (x->parent->left == x) {
-                        x->parent->left = tmp;
+                if (x->get_parent() && x->get_parent() != &_parent) {
+                    if (x->get_parent()->left == x) {
+                        x->get_parent()->left = tmp;
                     }
                     else {
-                        x->parent->right = tmp;
+                        x->get_parent()->right = tmp;
                     }
                 }
-                tmp->parent = x->parent;
-                x->parent = tmp;
+                tmp->set_parent(x->get_parent());
+                x->set_parent(tmp);
                 x->right = tmp->left;
                 if (x->right) {
-                    x->right->parent = x;
+                    x->right->set_parent(x);
                 }
                 tmp->left = x;
+                _update(x);
+                _update(tmp);
             }
 
             void    _insert_fix(Node *root) {
                 Node	*tmp;
-			    while (root->parent && root->parent != &_parent && root->parent->color == RED) {
-			    	if (root->parent == root->parent->parent->left) {
-			    		tmp = root->parent->parent->right;
-			    		if (tmp && tmp->color == RED) {
-			    			root->parent->color = BLACK;
-			    			tmp->color = BLACK;
-			    			root->parent->parent->color = RED;
-			    			root = root->parent->parent;
-			    		} else if (root == root->parent->right) {
-			    			root = root->parent;
+			    while (root->get_parent() && root->get_parent() != &_parent && root->get_parent()->get_color() == RED) {
+			    	if (root->get_parent() == root->get_parent()->get_parent()->left) {
+			    		tmp = root->get_parent()->get_parent()->right;
+			    		if (tmp && tmp->get_color() == RED) {
+			    			root->get_parent()->set_color(BLACK);
+			    			tmp->set_color(BLACK);
+			    			root->get_parent()->get_parent()->set_color(RED);
+			    			root = root->get_parent()->get_parent();
+			    		} else if (root == root->get_parent()->right) {
+			    			root = root->get_parent();
 			    			_rotate_left(root);
 			    		}
 			    		else {
-			    			root->parent->color = BLACK;
-			    			root->parent->parent->color = RED;
-			    			_rotate_right(root->parent->parent);
+			    			root->get_parent()->set_color(BLACK);
+			    			root->get_parent()->get_parent()->set_color(RED);
+			    			_rotate_right(root->get_parent()->get_parent());
 			    		}
 			    	}
 			    	else {
-			    		tmp = root->parent->parent->left;
-			    		if (tmp && tmp->color == RED) {
-			    			root->parent->color = BLACK;
-			    			tmp->color = BLACK;
-			    			root->parent->parent->color = RED;
-			    			root = root->parent->parent;
-			    		} else if (root == root->parent->left) {
-			    			root = root->parent;
+			    		tmp = root->get_parent()->get_parent()->left;
+			    		if (tmp && tmp->get_color() == RED) {
+			    			root->get_parent()->set_color(BLACK);
+			    			tmp->set_color(BLACK);
+			    			root->get_parent()->get_parent()->set_color(RED);
+			    			root = root->get_parent()->get_parent();
+			    		} else if (root == root->get_parent()->left) {
+			    			root = root->get_parent();
 			    			_rotate_right(root);
 			    		}
 			    		else {
-			    			root->parent->color = BLACK;
-			    			root->parent->parent->color = RED;
-			    			_rotate_left(root->parent->parent);
+			    			root->get_parent()->set_color(BLACK);
+			    			root->get_parent()->get_parent()->set_color(RED);
+			    			_rotate_left(root->get_parent()->get_parent());
 			    		}
 			    	}
 			    }
-			    _root->color = BLACK;
+			    _root->set_color(BLACK);
             }
 
             //find node that does not have a left child
@@ -302,12 +603,12 @@ template < class T,
             }
 
             Node    *_sibling(Node   *x) {
-                if (x->parent == NULL)
+                if (x->get_parent() == NULL)
                     return (NULL);
-                if (x->parent->left == x)
-                    return (x->parent->right);
+                if (x->get_parent()->left == x)
+                    return (x->get_parent()->right);
                 else
-                    return (x->parent->left);
+                    return (x->get_parent()->left);
             }
 
             Node    *_replace(Node *x) {
@@ -329,86 +630,87 @@ template < class T,
             }
 
             bool    _hasRedChild(Node *x) {
-                return ((x->left != NULL && x->left->color == RED) ||
-                    (x->right != NULL && x->right->color == RED));
+                return ((x->left != NULL && x->left->get_color() == RED) ||
+                    (x->right != NULL && x->right->get_color() == RED));
             }
 
+            // x carries an extra black. Each round either resolves it with at most
+            // two rotations or pushes it up to the parent, so this is a loop
             void    _fixDoubleBlack(Node *x) {
-                if (x == _root)
-                    return;
-                
-                Node    *sibling = _sibling(x);
-                Node    *parent = x->parent;
-                if (sibling == NULL) {
-                    // No sibling, double black pushed up
-                    _fixDoubleBlack(parent);
-                }
-                else {
-                    if (sibling->color == RED) {
-                        parent->color = RED;
-                        sibling->color = BLACK;
-                        if (sibling == sibling->parent->left) {
+                while (x != _root) {
+                    Node    *sibling = _sibling(x);
+                    Node    *parent = x->get_parent();
+                    if (sibling == NULL) {
+                        // No sibling, double black pushed up
+                        x = parent;
+                        continue ;
+                    }
+                    if (sibling->get_color() == RED) {
+                        parent->set_color(RED);
+                        sibling->set_color(BLACK);
+                        if (sibling == sibling->get_parent()->left) {
                             _rotate_right(parent);
                         }
                         else {
                             _rotate_left(parent);
                         }
-                        _fixDoubleBlack(x);
+                        continue ;
                     }
-                    else {
-                        //Sibling black
-                        if (_hasRedChild(sibling)) {
-                            // at least 1 red children
-                            if (sibling->left != NULL && sibling->left->color == RED) {
-                                if (sibling == sibling->parent->left) {
-                                    // left left
-                                    sibling->left->color = sibling->color;
-                                    sibling->color =parent->color;
-                                    _rotate_right(parent);
-                                }
-                                else {
-                                    // right left
-                                    sibling->left->color = parent->color;
-                                    _rotate_right(sibling);
-                                    _rotate_left(parent);
-                                }
+                    //Sibling black
+                    if (_hasRedChild(sibling)) {
+                        // at least 1 red children
+                        if (sibling->left != NULL && sibling->left->get_color() == RED) {
+                            if (sibling == sibling->get_parent()->left) {
+                                // left left
+                                sibling->left->set_color(sibling->get_color());
+                                sibling->set_color(parent->get_color());
+                                _rotate_right(parent);
                             }
                             else {
-                                if (sibling == sibling->parent->left) {
-                                    // left right
-                                    sibling->right->color = parent->color;
-                                    _rotate_left(sibling);
-                                    _rotate_right(parent);
-                                }
-                                else {
-                                    // right right
-                                    sibling->right->color = sibling->color;
-                                    sibling->color = parent->color;
-                                    _rotate_left(parent);
-                                }
+                                // right left
+                                sibling->left->set_color(parent->get_color());
+                                _rotate_right(sibling);
+                                _rotate_left(parent);
                             }
-                            parent->color = BLACK;
                         }
                         else {
-                            // 2 black children
-                            sibling->color = RED;
-                            if (parent->color == BLACK)
-                                _fixDoubleBlack(parent);
-                            else
-                                parent->color = BLACK;
+                            if (sibling == sibling->get_parent()->left) {
+                                // left right
+                                sibling->right->set_color(parent->get_color());
+                                _rotate_left(sibling);
+                                _rotate_right(parent);
+                            }
+                            else {
+                                // right right
+                                sibling->right->set_color(sibling->get_color());
+                                sibling->set_color(parent->get_color());
+                                _rotate_left(parent);
+                            }
                         }
+                        parent->set_color(BLACK);
+                        return ;
                     }
+                    // 2 black children
+                    sibling->set_color(RED);
+                    if (parent->get_color() == RED) {
+                        parent->set_color(BLACK);
+                        return ;
+                    }
+                    x = parent;
                 }
             }
 
-            void    _deleteNode(Node *v) {
-                if (v == NULL)
-                    return ;
+            // takes v out of the tree and rebalances, the node itself is left alone
+            void    _unlink(Node *v) {
+                if (v == _leftmost)
+                    _leftmost = _successor(v);
+                if (v == _parent.right)
+                    _parent.right = _predecessor(v);
                 Node    *u = _replace(v);
 
                 //True when u and v are both black
-                bool    uvBlack = ((u == NULL || u->color == BLACK) && v->color == BLACK);
-                Node    *parent = v->parent;
+                bool    uvBlack = ((u == NULL || u->get_color() == BLACK) && v->get_color() == BLACK);
+                Node    *parent = v->get_parent();
 
                 if (u == NULL) {
                     // u is NULL therefore v is leaf
@@ -427,17 +729,17 @@ template < class T,
                             // u or v is red
                             if (_sibling(v) != NULL) {
                                 // sibling is not null, make it red
-                                _sibling(v)->color = RED;
+                                _sibling(v)->set_color(RED);
                             }
                         }
 
                         // delete v from the tree
-                        if (v->parent->left == v)
+                        if (v->get_parent()->left == v)
                             parent->left = NULL;
                         else
                             parent->right = NULL;
+                        _update_path(parent);
                     }
-                    _removeNode(v);
                     return ;
                 }
 
@@ -446,29 +748,30 @@ template < class T,
                     if (v == _root) {
                         // v is root, assign the value of u to v, and delete u
                         _root = u;
-                        _root->parent = &_parent;
+                        _root->set_parent(&_parent);
+                        _parent.left = _root;
                         u->left = NULL;
                         u->right = NULL;
-                        u->color = BLACK;
-                        _removeNode(v);
+                        u->set_color(BLACK);
+                        _update(u);
                     }
                     else {
                         // Detach v from tree and move u up
-                        if (v->parent->left == v) {
+                        if (v->get_parent()->left == v) {
                             parent->left = u;
                         }
                         else {
                             parent->right = u;
                         }
-                        _removeNode(v);
-                        u->parent = parent;
+                        u->set_parent(parent);
+                        _update_path(parent);
                         if (uvBlack) {
                             //u and v both are black, fix double black at u
                             _fixDoubleBlack(u);
                         }
                         else {
                             // u or v are red, color u black
-                            u->color = BLACK;
+                            u->set_color(BLACK);
                         }
                     }
                     return ;
@@ -478,29 +781,269 @@ template < class T,
                 if (v == _root) {
                     _root = u;
                 }
-                if (v->parent && v == v->parent->left) {
-                    v->parent->left = u;
+                if (v->get_parent() && v == v->get_parent()->left) {
+                    v->get_parent()->left = u;
                 }
-                else if (v->parent && v->parent->right == v) {
-				    v->parent->right = u;
+                else if (v->get_parent() && v->get_parent()->right == v) {
+				    v->get_parent()->right = u;
 			    }
 			    if (v->right) {
-			    	v->right->parent = u;
+			    	v->right->set_parent(u);
 			    }
 			    if (v->left) {
-			    	v->left->parent = u;
+			    	v->left->set_parent(u);
 			    }
-			    if (u->parent && u == u->parent->left) {
-			    	u->parent->left = v;
+			    if (u->get_parent() && u == u->get_parent()->left) {
+			    	u->get_parent()->left = v;
 			    }
-			    if (u->parent && u == u->parent->right) {
-			    	u->parent->right = v;
+			    if (u->get_parent() && u == u->get_parent()->right) {
+			    	u->get_parent()->right = v;
 			    }
-			    ft::swap(u->parent, v->parent);
+			    Node        *tmp_parent = u->get_parent();
+			    tree_color  tmp_color = u->get_color();
+			    u->set_parent(v->get_parent());
+			    v->set_parent(tmp_parent);
 			    ft::swap(u->left, v->left);
 			    ft::swap(u->right, v->right);
-			    ft::swap(u->color, v->color);
-			    _deleteNode(v);
+			    u->set_color(v->get_color());
+			    v->set_color(tmp_color);
+# ifdef FT_ORDER_STATISTICS
+			    ft::swap(u->size, v->size);
+# endif
+			    _unlink(v);
+            }
+
+            void    _deleteNode(Node *v) {
+                if (v == NULL)
+                    return ;
+                _unlink(v);
+                _removeNode(v);
+            }
+
+            Node    *_select(size_type k) const {
+# ifdef FT_ORDER_STATISTICS
+                return (tree_select(const_cast<Node *>(&_parent), k));
+# else
+                const_iterator  it = begin();
+                for (; k > 0 && it != end(); --k)
+                    ++it;
+                return (const_cast<Node *>(it.base()));
+# endif
+            }
+
+            // links node as a red leaf, left or right child of parent, and rebalances
+            Node    *_link_at(Node *parent, bool left, Node *node) {
+                node->set_parent(parent);
+                node->left = NULL;
+                node->right = NULL;
+                node->set_color(RED);
+                _update(node);
+                if (left) {
+                    parent->left = node;
+                    if (parent == _leftmost)
+                        _leftmost = node;
+                }
+                else {
+                    parent->right = node;
+                    if (parent == _parent.right)
+                        _parent.right = node;
+                }
+                _update_path(parent);
+                _insert_fix(node);
+                _size++;
+                return (node);
+            }
+
+            Node    *_insert_at(Node *parent, bool left, value_type const &val) {
+                return (_link_at(parent, left, _createNode(val)));
+            }
+
+            // links a detached node at its place, unless an equal element is
+            // already there, which is returned instead
+            ft::pair<Node *, bool>  _insert_node(Node *node) {
+                if (_root == NULL) {
+                    node->left = NULL;
+                    node->right = NULL;
+                    node->set_color(BLACK);
+                    _update(node);
+                    _set_root(node);
+                    _size++;
+                    return (ft::make_pair(node, true));
+                }
+                Node    *pos;
+                bool    left;
+                Node    *found = _insert_position(node->data, pos, left);
+                if (found != NULL)
+                    return (ft::make_pair(found, false));
+                return (ft::make_pair(_link_at(pos, left, node), true));
+            }
+
+            // the element is linked from node if there is one, otherwise
+            // a new node is created from val
+            Node    *_place(Node *parent, bool left, value_type const &val, Node *node) {
+                if (node)
+                    return (_link_at(parent, left, node));
+                return (_insert_at(parent, left, val));
+            }
+
+            // if val belongs right before or right after hint it is linked there
+            // directly, otherwise this falls back to a search from the root
+            Node    *_insert_hint(Node *hint, value_type const &val, Node *node = NULL) {
+                if (_root == NULL)
+                    return (_fallback_insert(val, node));
+                if (hint == &_parent || _cmp(val, hint->data)) {
+                    Node    *prev = (hint == &_parent ? _parent.right : _predecessor(hint));
+                    if (prev == NULL)
+                        return (_place(hint, true, val, node));
+                    if (_cmp(prev->data, val)) {
+                        if (prev->right == NULL)
+                            return (_place(prev, false, val, node));
+                        return (_place(hint, true, val, node));
+                    }
+                }
+                else if (_cmp(hint->data, val)) {
+                    Node    *next = _successor(hint);
+                    if (next == &_parent || _cmp(val, next->data)) {
+                        if (hint->right == NULL)
+                            return (_place(hint, false, val, node));
+                        return (_place(next, true, val, node));
+                    }
+                }
+                else
+                    return (hint);
+                return (_fallback_insert(val, node));
+            }
+
+            Node    *_fallback_insert(value_type const &val, Node *node) {
+                if (node)
+                    return (_insert_node(node).first);
+                return (insert(val).first.base());
+            }
+
+            template<class InputIterator>
+                void    _insert_range(InputIterator first, InputIterator last, ft::input_iterator_tag) {
+                    for (; first != last; ++first)
+                        _insert_hint(&_parent, *first);
+                }
+
+            // an empty tree filled from a strictly ascending range is built
+            // directly in O(n), any other range is inserted element by element
+            template<class ForwardIterator>
+                void    _insert_range(ForwardIterator first, ForwardIterator last, ft::forward_iterator_tag) {
+                    if (_root != NULL || first == last) {
+                        _insert_range(first, last, ft::input_iterator_tag());
+                        return ;
+                    }
+                    size_type       n = 1;
+                    ForwardIterator prev = first;
+                    ForwardIterator curr = first;
+                    for (++curr; curr != last; ++prev, ++curr, ++n) {
+                        if (!_cmp(*prev, *curr)) {
+                            _insert_range(first, last, ft::input_iterator_tag());
+                            return ;
+                        }
+                    }
+                    _set_root(_build_balanced(first, n));
+                    _size = n;
+                }
+
+            // balanced tree from the n sorted elements at first, its root is black
+            template<class ForwardIterator>
+                Node    *_build_balanced(ForwardIterator first, size_type n) {
+                    size_type   red_depth = 0;
+                    for (size_type i = n + 1; i > 1; i >>= 1)
+                        ++red_depth;
+                    return (_build(first, n, 0, red_depth));
+                }
+
+            // builds a balanced subtree of n nodes from the sorted range at first.
+            // All leaves end up on the last two levels, nodes on the last level are
+            // coloured red when it is incomplete and every other node black
+            template<class ForwardIterator>
+                Node    *_build(ForwardIterator &first, size_type n, size_type depth, size_type red_depth) {
+                    if (n == 0)
+                        return (NULL);
+                    size_type   half = (n - 1) / 2;
+                    Node        *left = _build(first, half, depth + 1, red_depth);
+                    Node        *node = _createNode(*first);
+                    ++first;
+                    node->set_color(depth == red_depth ? RED : BLACK);
+                    node->left = left;
+                    if (left)
+                        left->set_parent(node);
+                    node->right = _build(first, n - 1 - half, depth + 1, red_depth);
+                    if (node->right)
+                        node->right->set_parent(node);
+                    _update(node);
+                    return (node);
+                }
+
+            // first node in the subtree of root that is not less than key,
+            // bound is returned if there is none
+            template <class K>
+            Node    *_lower_bound(Node *root, Node *bound, K const &key) const {
+                while (root != NULL) {
+                    _prefetch_children(root);
+                    _descend(root, bound, _cmp(root->data, key));
+                }
+                return (bound);
+            }
+
+            // Lower bound of key searched from node instead of from the root: it
+            // climbs only up to the subtree that holds the answer, so a key close
+            // to node is found in about the log of the distance between them.
+            // A key that is further than _max_climb levels up is searched from
+            // the root, which does not have to wait for node to be loaded and so
+            // overlaps with the searches around it.
+            static const size_type  _max_climb = 5;
+
+            template <class K>
+            Node    *_lower_bound_from(Node *node, K const &key) const {
+                Node    *header = const_cast<Node *>(&_parent);
+                if (node == NULL || node == header)
+                    return (_lower_bound(_root, header, key));
+                bool    forward = _cmp(node->data, key);
+                for (size_type steps = 0; node != _root && steps < _max_climb; ++steps) {
+                    Node    *p = node->get_parent();
+                    if (forward && node == p->left && !_cmp(p->data, key))
+                        return (_lower_bound(node, p, key));
+                    if (!forward && node == p->right && _cmp(p->data, key))
+                        return (_lower_bound(node, header, key));
+                    node = p;
+                }
+                return (_lower_bound(_root, header, key));
+            }
+
+            // first node in the subtree of root that is greater than key,
+            // bound is returned if there is none
+            template <class K>
+            Node    *_upper_bound(Node *root, Node *bound, K const &key) const {
+                while (root != NULL) {
+                    _prefetch_children(root);
+                    _descend(root, bound, !_cmp(key, root->data));
+                }
+                return (bound);
+            }
+
+            // descends once until the paths of lower and upper bound split,
+            // then finishes both bounds in the subtrees of the matching node
+            template <class K>
+            ft::pair<Node *, Node *>    _equal_range(K const &key) const {
+                Node    *root = _root;
+                Node    *upper = const_cast<Node *>(&_parent);
+                while (root != NULL) {
+                    _prefetch_children(root);
+                    if (_cmp(root->data, key))
+                        root = root->right;
+                    else if (_cmp(key, root->data)) {
+                        upper = root;
+                        root = root->left;
+                    }
+                    else
+                        return (ft::make_pair(_lower_bound(root->left, root, key),
+                                              _upper_bound(root->right, upper, key)));
+                }
+                return (ft::make_pair(upper, upper));
             }
 
             void    _printTreeHelper(Node *root, std::string indent, bool end) {
@@ -514,18 +1057,409 @@ template < class T,
                         std::cout << "├────";
                         indent += "|    ";
                     }
-                    std::cout << root->data.first << " " << root->data.second << " " << (root->color ? "black":"red") << std::endl;
+                    std::cout << root->data.first << " " << root->data.second << " " << (root->get_color() ? "black":"red") << std::endl;
                     _printTreeHelper(root->left, indent, false);
                     _printTreeHelper(root->right, indent, true);
                 }
             }
 
-            void    _insert_range_in_preorder(RB_BST &tree, Node *node) {
-                if (node == NULL)
+            // clones the subtree of src node by node, keeping its shape and colours
+            Node    *_copy(Node const *src, Node *parent) {
+                if (src == NULL)
+                    return (NULL);
+                Node    *node = _createNode(src->data);
+                node->set_color(src->get_color());
+                node->set_parent(parent);
+                node->left = _copy(src->left, node);
+                node->right = _copy(src->right, node);
+                _update(node);
+                return (node);
+            }
+
+            void    _copy_tree(RB_BST const &src) {
+                _set_root(_copy(src._root, &_parent));
+                _size = src._size;
+            }
+
+            // links root and its first and last node to the header
+            void    _adopt(Node *root, Node *first, Node *last) {
+                _root = root;
+                if (root == NULL) {
+                    _parent.left = &_parent;
+                    _parent.right = NULL;
+                    _leftmost = &_parent;
                     return ;
-                tree.insert(node->data);
-                _insert_range_in_preorder(tree, node->left);
-                _insert_range_in_preorder(tree, node->right);
+                }
+                root->set_parent(&_parent);
+                _parent.left = root;
+                _parent.right = last;
+                _leftmost = first;
+            }
+
+            void    _set_root(Node *root) {
+                _adopt(root, _minimum(root), _maximum(root));
+            }
+
+            // Split and join work on detached subtrees: the parent link of the root
+            // of a subtree is not looked at, whoever links the subtree sets it.
+            // Every subtree handed to _join has a black root and its black height
+            // (black nodes from the root down to a leaf, the root included) is
+            // passed along, so it never has to be recomputed.
+
+            static size_type    _black_height(Node const *root) {
+                size_type   h = 0;
+                for (; root != NULL; root = root->left) {
+                    if (root->get_color() == BLACK)
+                        ++h;
+                }
+                return (h);
+            }
+
+            // colouring the root black never breaks a tree, it just adds a level
+            static Node *_blacken(Node *root, size_type &h) {
+                if (root && root->get_color() == RED) {
+                    root->set_color(BLACK);
+                    ++h;
+                }
+                return (root);
+            }
+
+            Node    *_link(Node *l, Node *k, Node *r, tree_color color) {
+                k->left = l;
+                if (l)
+                    l->set_parent(k);
+                k->right = r;
+                if (r)
+                    r->set_parent(k);
+                k->set_color(color);
+                _update(k);
+                return (k);
+            }
+
+            Node    *_rotate_left_detached(Node *x) {
+                Node    *tmp = x->right;
+                x->right = tmp->left;
+                if (x->right)
+                    x->right->set_parent(x);
+                tmp->left = x;
+                x->set_parent(tmp);
+                _update(x);
+                _update(tmp);
+                return (tmp);
+            }
+
+            Node    *_rotate_right_detached(Node *z) {
+                Node    *tmp = z->left;
+                z->left = tmp->right;
+                if (z->left)
+                    z->left->set_parent(z);
+                tmp->right = z;
+                z->set_parent(tmp);
+                _update(z);
+                _update(tmp);
+                return (tmp);
+            }
+
+            // lh >= rh: walks down the right spine of l to a black node of height rh
+            // and hangs k there, red, with that node and r as children. A red k
+            // below a red node is lifted by a rotation on the way back up
+            Node    *_join_right(Node *l, size_type lh, Node *k, Node *r, size_type rh) {
+                if (lh == rh && (l == NULL || l->get_color() == BLACK))
+                    return (_link(l, k, r, RED));
+                Node    *sub = _join_right(l->right, lh - (l->get_color() == BLACK), k, r, rh);
+                l->right = sub;
+                sub->set_parent(l);
+                _update(l);
+                if (l->get_color() == BLACK && sub->get_color() == RED
+                    && sub->right && sub->right->get_color() == RED) {
+                    sub->right->set_color(BLACK);
+                    return (_rotate_left_detached(l));
+                }
+                return (l);
+            }
+
+            // mirror image of _join_right for lh < rh
+            Node    *_join_left(Node *l, size_type lh, Node *k, Node *r, size_type rh) {
+                if (lh == rh && (r == NULL || r->get_color() == BLACK))
+                    return (_link(l, k, r, RED));
+                Node    *sub = _join_left(l, lh, k, r->left, rh - (r->get_color() == BLACK));
+                r->left = sub;
+                sub->set_parent(r);
+                _update(r);
+                if (r->get_color() == BLACK && sub->get_color() == RED
+                    && sub->left && sub->left->get_color() == RED) {
+                    sub->left->set_color(BLACK);
+                    return (_rotate_right_detached(r));
+                }
+                return (r);
+            }
+
+            // joins l, k and r (everything in l < k < everything in r) into one
+            // tree in O(|lh - rh| + 1). h is set to the height of the result
+            Node    *_join(Node *l, size_type lh, Node *k, Node *r, size_type rh, size_type &h) {
+                Node    *root;
+                if (lh > rh)
+                    root = _join_right(l, lh, k, r, rh);
+                else if (lh < rh)
+                    root = _join_left(l, lh, k, r, rh);
+                else
+                    root = _link(l, k, r, RED);
+                h = (lh > rh ? lh : rh);
+                return (_blacken(root, h));
+            }
+
+            // splits the subtree of root (height h) into the nodes that go left
+            // (less than key, or not greater than key if upper) and the others.
+            // Every node on the search path is joined back into one of the sides,
+            // the joins get taller on the way up so the total work is O(log n)
+            template <class K>
+            void    _split(Node *root, size_type h, K const &key, bool upper,
+                           Node *&left, size_type &lh, Node *&right, size_type &rh) {
+                if (root == NULL) {
+                    left = NULL;
+                    right = NULL;
+                    lh = 0;
+                    rh = 0;
+                    return ;
+                }
+                size_type   child_h = h - (root->get_color() == BLACK);
+                Node        *l = root->left;
+                Node        *r = root->right;
+                size_type   side_h = child_h;
+                if (upper ? _cmp(key, root->data) : !_cmp(root->data, key)) {
+                    _split(l, child_h, key, upper, left, lh, right, rh);
+                    _blacken(r, side_h);
+                    right = _join(right, rh, root, r, side_h, rh);
+                }
+                else {
+                    _split(r, child_h, key, upper, left, lh, right, rh);
+                    _blacken(l, side_h);
+                    left = _join(l, side_h, root, left, lh, lh);
+                }
+            }
+
+# ifdef FT_ORDER_STATISTICS
+            // moves the nodes that do not go left of key into right, which has to
+            // share the node allocator so the nodes can be freed from there. The
+            // sizes of both sides are read from the subtree sizes: without them
+            // one side would have to be counted, which is O(n)
+            template <class K>
+            void    _split_tree(K const &key, bool upper, RB_BST &right) {
+                right.clear();
+                right._cmp = _cmp;
+                right._alloc = _alloc;
+                right._node_alloc = _node_alloc;
+                Node        *l;
+                Node        *r;
+                size_type   lh;
+                size_type   rh;
+                _split(_root, _black_height(_root), key, upper, l, lh, r, rh);
+                _set_root(l);
+                right._set_root(r);
+                right._size = tree_subtree_size(r);
+                _size -= right._size;
+            }
+# endif
+
+            enum _set_op { _UNION, _INTERSECTION, _DIFFERENCE, _SYMMETRIC_DIFFERENCE };
+
+            typedef typename Alloc::template rebind<Node const *>::other    _node_ptr_allocator;
+
+            // walks a buffer of nodes like a range of their values, for _build
+            struct _node_data_iterator {
+                Node const * const  *p;
+
+                value_type const    &operator*() const { return ((*p)->data); }
+                _node_data_iterator &operator++() { ++p; return (*this); }
+            };
+
+            // true when m lookups of O(log total) each beat a walk over all elements
+            static bool _skewed(size_type m, size_type total) {
+                size_type   log_total = 1;
+                for (size_type i = total; i > 1; i >>= 1)
+                    ++log_total;
+                return (m * log_total < total);
+            }
+
+            // appends the nodes of the result of op in order to buf, returns their count.
+            // When one side is so much smaller that looking its elements up in the
+            // other is cheaper than walking both, only the smaller side is walked;
+            // that works for the results that are a subset of the smaller side
+            size_type   _collect(RB_BST const &other, _set_op op, Node const **buf) const {
+                size_type   n = 0;
+                size_type   small = (_size < other._size ? _size : other._size);
+                if ((op == _INTERSECTION || (op == _DIFFERENCE && _size == small))
+                    && _skewed(small, _size + other._size)) {
+                    if (op == _INTERSECTION && other._size == small) {
+                        for (const_iterator b = other.begin(); b != other.end(); ++b) {
+                            Node const  *found = _find(*b);
+                            if (found != NULL)
+                                buf[n++] = found;
+                        }
+                        return (n);
+                    }
+                    for (const_iterator a = begin(); a != end(); ++a) {
+                        if ((other._find(*a) != NULL) == (op == _INTERSECTION))
+                            buf[n++] = a.base();
+                    }
+                    return (n);
+                }
+                const_iterator  a = begin();
+                const_iterator  b = other.begin();
+                while (a != end() && b != other.end()) {
+                    if (_cmp(*a, *b)) {
+                        if (op != _INTERSECTION)
+                            buf[n++] = a.base();
+                        ++a;
+                    }
+                    else if (_cmp(*b, *a)) {
+                        if (op == _UNION || op == _SYMMETRIC_DIFFERENCE)
+                            buf[n++] = b.base();
+                        ++b;
+                    }
+                    else {
+                        if (op == _UNION || op == _INTERSECTION)
+                            buf[n++] = a.base();
+                        ++a;
+                        ++b;
+                    }
+                }
+                if (op != _INTERSECTION) {
+                    for (; a != end(); ++a)
+                        buf[n++] = a.base();
+                }
+                if (op == _UNION || op == _SYMMETRIC_DIFFERENCE) {
+                    for (; b != other.end(); ++b)
+                        buf[n++] = b.base();
+                }
+                return (n);
+            }
+
+            typedef typename Alloc::template rebind<Node *>::other  _node_buf_allocator;
+
+            // joins two subtrees whose elements are all ordered l < r, by taking
+            // the first node of r out to stand between them
+            Node    *_join_pair(Node *l, size_type lh, Node *r, size_type rh, size_type &h) {
+                if (r == NULL) {
+                    h = lh;
+                    return (l);
+                }
+                Node        *first = _minimum(r);
+                Node        *one;
+                Node        *rest;
+                size_type   oneh;
+                size_type   resth;
+                _split(r, rh, first->data, true, one, oneh, rest, resth);
+                return (_join(l, lh, first, rest, resth, h));
+            }
+
+            // merges the sorted new nodes [nodes, nodes + m) into the subtree of root
+            // (height h): the middle node splits the tree, both halves of the nodes
+            // go into their side and the sides are joined back around it. That is
+            // O(m log(n / m + 1)) for m nodes into n elements. On equal keys the
+            // union keeps the node of the tree unless replace is set, the
+            // symmetric difference drops both
+            Node    *_merge_nodes(Node *root, size_type h, Node **nodes, size_type m,
+                                  _set_op op, bool replace, size_type &rh) {
+                if (m == 0) {
+                    rh = h;
+                    return (root);
+                }
+                size_type   mid = m / 2;
+                Node        *k = nodes[mid];
+                Node        *l;
+                Node        *rest;
+                Node        *eq;
+                Node        *r;
+                size_type   lh;
+                size_type   resth;
+                size_type   eqh;
+                size_type   r_h;
+                _split(root, h, k->data, false, l, lh, rest, resth);
+                _split(rest, resth, k->data, true, eq, eqh, r, r_h);
+                l = _merge_nodes(l, lh, nodes, mid, op, replace, lh);
+                r = _merge_nodes(r, r_h, nodes + mid + 1, m - mid - 1, op, replace, r_h);
+                if (eq == NULL)
+                    ++_size;
+                else if (op == _SYMMETRIC_DIFFERENCE) {
+                    _removeNode(k);
+                    _removeNode(eq);
+                    --_size;
+                    return (_join_pair(l, lh, r, r_h, rh));
+                }
+                else if (replace)
+                    _removeNode(eq);
+                else {
+                    _removeNode(k);
+                    k = eq;
+                }
+                return (_join(l, lh, k, r, r_h, rh));
+            }
+
+            // merges copies of the elements of small into this tree in place. The
+            // copies are all made first, so a throwing copy leaves the tree as it was
+            void    _merge_small(RB_BST const &small, _set_op op, bool replace) {
+                if (small._size == 0)
+                    return ;
+                _node_buf_allocator buf_alloc(_alloc);
+                size_type           n = small._size;
+                Node                **nodes = buf_alloc.allocate(n);
+                size_type           made = 0;
+                try {
+                    for (const_iterator it = small.begin(); it != small.end(); ++it)
+                        nodes[made++] = _createNode(*it);
+                }
+                catch (...) {
+                    while (made > 0)
+                        _removeNode(nodes[--made]);
+                    buf_alloc.deallocate(nodes, n);
+                    throw ;
+                }
+                size_type   h;
+                Node        *root = _merge_nodes(_root, _black_height(_root), nodes, n, op, replace, h);
+                buf_alloc.deallocate(nodes, n);
+                _set_root(root);
+            }
+
+            // the result is collected first and built in one go in O(n), so out
+            // may be this tree or other. Elements found in both come from this tree.
+            // A union or symmetric difference stored into the larger operand merges
+            // the smaller one into it in place when that is much smaller
+            void    _set_operation(RB_BST const &other, RB_BST &out, _set_op op) const {
+                if ((op == _UNION || op == _SYMMETRIC_DIFFERENCE) && this != &other
+                    && (&out == this || &out == &other)) {
+                    RB_BST const    &small = (&out == this ? other : *this);
+                    if (_skewed(small._size, _size + other._size)) {
+                        out._merge_small(small, op, op == _UNION && &out == &other);
+                        return ;
+                    }
+                }
+                size_type   cap = _size + other._size;
+                if (op == _INTERSECTION)
+                    cap = (_size < other._size ? _size : other._size);
+                else if (op == _DIFFERENCE)
+                    cap = _size;
+                if (cap == 0) {
+                    out.clear();
+                    return ;
+                }
+                _node_ptr_allocator     ptr_alloc(_alloc);
+                Node const              **buf = ptr_alloc.allocate(cap);
+                size_type               n = _collect(other, op, buf);
+                _node_data_iterator     it;
+                it.p = buf;
+                Node                    *root = NULL;
+                try {
+                    root = out._build_balanced(it, n);
+                }
+                catch (...) {
+                    ptr_alloc.deallocate(buf, cap);
+                    throw ;
+                }
+                ptr_alloc.deallocate(buf, cap);
+                out.clear();
+                out._set_root(root);
+                out._size = n;
             }
 
 /*             void    _inorder(Node *node) {
@@ -562,37 +1496,57 @@ template < class T,
             } */
 
         public:
-            explicit RB_BST(const value_compare& cmp = value_compare(), const allocator_type &alloc = allocator_type()) : _parent(), _root(NULL), _alloc(alloc), _node_alloc(alloc), _cmp(cmp), _size(0) {
+            explicit RB_BST(const value_compare& cmp = value_compare(), const allocator_type &alloc = allocator_type()) : _parent(), _root(NULL), _leftmost(&_parent), _alloc(alloc), _node_alloc(alloc), _cmp(cmp), _size(0) {
+                _parent.left = &_parent;
+                _parent.right = NULL;
+            }
+
+            RB_BST(RB_BST const &src) : _parent(), _root(), _leftmost(&_parent), _alloc(_copy_alloc(src._alloc)), _node_alloc(_copy_alloc(src._node_alloc)), _cmp(src._cmp), _size() {
                 _parent.left = &_parent;
                 _parent.right = NULL;
+                _copy_tree(src);
             }
 
-            RB_BST(RB_BST const &src) : _parent(), _root(), _alloc(src._alloc), _node_alloc(src._node_alloc), _cmp(src._cmp), _size() {
+# ifdef FT_CXX11
+            RB_BST(RB_BST &&src) : _parent(), _root(NULL), _leftmost(&_parent), _alloc(src._alloc), _node_alloc(src._node_alloc), _cmp(src._cmp), _size(0) {
                 _parent.left = &_parent;
                 _parent.right = NULL;
-                _insert_range_in_preorder(*this, src._root);
+                swap(src);
             }
+# endif
 
             ~RB_BST() {
                 clear();
             }
 
             RB_BST    &operator=(RB_BST const &rhs) {
+                if (this == &rhs)
+                    return *this;
                 this->clear();
                 _cmp = rhs._cmp;
-                _alloc = rhs._alloc;
-                _node_alloc = rhs._node_alloc;
-                _insert_range_in_preorder(*this, rhs._root);
+                _assign_alloc(_alloc, rhs._alloc);
+                _assign_alloc(_node_alloc, rhs._node_alloc);
+                _copy_tree(rhs);
                 return *this;
             }
 
+# ifdef FT_CXX11
+            RB_BST    &operator=(RB_BST &&rhs) {
+                if (this == &rhs)
+                    return *this;
+                this->clear();
+                swap(rhs);
+                return *this;
+            }
+# endif
+
             /* --- Iterators --- */
             iterator    begin() {
-                return (iterator(_minimum(_parent.left)));
+                return (iterator(_leftmost));
             }
 
             const_iterator begin() const {
-                return (const_iterator(_minimum(_parent.left)));
+                return (const_iterator(_leftmost));
             }
 
             iterator    end() {
@@ -629,7 +1583,14 @@ template < class T,
             }
 
             size_type   max_size() const {
-                return _node_alloc.max_size();
+                return (_max_nodes(_node_alloc));
+            }
+
+            void    reserve(size_type n) {
+                if (n > max_size())
+                    throw std::length_error("RB_BST");
+                if (n > _size)
+                    _reserve_nodes(_node_alloc, n - _size);
             }
 
             /* --- Element access --- */
@@ -641,82 +1602,210 @@ template < class T,
             /* --- Modifiers --- */
             ft::pair<iterator, bool>    insert(value_type const &to_insert) {
                 Node    *tmp;
-                Node    *ret;
 
                 if (empty()) {
                     Node    *newNode = _createNode(to_insert);
-                    _root = newNode;
-                    _root->parent = &_parent;
-                    _parent.left = _root;
-                    _root->color = BLACK;
+                    newNode->set_color(BLACK);
+                    _adopt(newNode, newNode, newNode);
                     _size++;
                     return (ft::make_pair(iterator(_root), true));
                 }
-                tmp = _searchTreeHelper(_root, to_insert);
-                if (_equals(to_insert, tmp->data)) {
-                    return (ft::make_pair(iterator(tmp), false));
-                }
-                else if (_cmp(to_insert, tmp->data)) {
-                    tmp->left = _createNode(to_insert);
-                    ret = tmp->left;
-                    tmp->left->parent = tmp;
-                    _insert_fix(tmp->left);
-                    _size++;
-                    return (ft::make_pair(iterator(ret), true));
-                }
-                else {
-                    tmp->right = _createNode(to_insert);
-                    ret = tmp->right;
-                    tmp->right->parent = tmp;
-                    _insert_fix(tmp->right);
-                    _size++;
-                    return (ft::make_pair(iterator(ret), true));
-                }
+                bool    left;
+                Node    *found = _insert_position(to_insert, tmp, left);
+                if (found != NULL)
+                    return (ft::make_pair(iterator(found), false));
+                return (ft::make_pair(iterator(_insert_at(tmp, left, to_insert)), true));
             }
 
             iterator    insert(iterator pos, value_type const &to_insert) {
-                (void) pos;
-                return insert(to_insert).first;
+                return (iterator(_insert_hint(pos.base(), to_insert)));
+            }
+
+            const_iterator  insert(const_iterator pos, value_type const &to_insert) {
+                return (const_iterator(_insert_hint(const_cast<Node *>(pos.base()), to_insert)));
+            }
+
+# ifdef FT_CXX11
+            // the node is only built once the key is known to be missing
+            ft::pair<iterator, bool>    insert(value_type &&to_insert) {
+                if (empty())
+                    return (emplace(std::move(to_insert)));
+                Node    *tmp;
+                bool    left;
+                Node    *found = _insert_position(to_insert, tmp, left);
+                if (found != NULL)
+                    return (ft::make_pair(iterator(found), false));
+                return (ft::make_pair(iterator(_link_at(tmp, left, _createNode(std::move(to_insert)))), true));
             }
 
+            iterator    insert(iterator pos, value_type &&to_insert) {
+                return (emplace_hint(pos, std::move(to_insert)));
+            }
+
+            const_iterator  insert(const_iterator pos, value_type &&to_insert) {
+                return (emplace_hint(pos, std::move(to_insert)));
+            }
+
+            // the element is built in a new node before its key can be
+            // compared. The node is freed again if the key is already there
+            template <class... Args>
+                ft::pair<iterator, bool>    emplace(Args&&... args) {
+                    Node                    *node = _createNode(std::forward<Args>(args)...);
+                    ft::pair<Node *, bool>  ret = _insert_node(node);
+                    if (!ret.second)
+                        _removeNode(node);
+                    return (ft::make_pair(iterator(ret.first), ret.second));
+                }
+
+            template <class... Args>
+                iterator    emplace_hint(const_iterator hint, Args&&... args) {
+                    Node    *node = _createNode(std::forward<Args>(args)...);
+                    Node    *ret = _insert_hint(const_cast<Node *>(hint.base()), node->data, node);
+                    if (ret != node)
+                        _removeNode(node);
+                    return (iterator(ret));
+                }
+# endif
+
             template<class InputIterator>
                 void    insert(InputIterator first, InputIterator last) {
-                    while (first != last) {
-                        insert(*first);
-                        ++first;
-                    }
+                    _insert_range(first, last, ft::iterator_category(first));
                 }
 
-            size_type    deleteNode(value_type const &to_delete) {
-                Node    *v = _searchTreeHelper(_root, to_delete);
-                if (_root == NULL || !_equals(to_delete, v->data))
+            size_type    deleteNode(key_type const &to_delete) {
+                Node    *v = _find(to_delete);
+                if (v == NULL)
                     return 0;
                 _deleteNode(v);
                 _size--;
                 return 1;
             }
 
-            void    deleteNode(iterator first, iterator last) {
-                while(first != last) {
-                    deleteNode(first++.base()->data);
+            // unlinks the node pos points to, no search needed
+            void    deleteNode(const_iterator pos) {
+                _deleteNode(const_cast<Node *>(pos.base()));
+                _size--;
+            }
+
+            // nodes keep their place in memory while the tree is rebalanced,
+            // so first can be advanced before its predecessor is unlinked
+            void    deleteNode(const_iterator first, const_iterator last) {
+                if (first == begin() && last == end()) {
+                    clear();
+                    return ;
+                }
+                while (first != last) {
+                    deleteNode(first++);
+                }
+            }
+
+            /* --- Node handles --- */
+            // unlinks the node at pos and hands it over, nothing is freed
+            node_type   extract(const_iterator pos) {
+                Node    *node = const_cast<Node *>(pos.base());
+                _unlink(node);
+                _size--;
+                return (node_type(node, _alloc, _node_alloc));
+            }
+
+            node_type   extract(key_type const &key) {
+                Node    *node = _find(key);
+                if (node == NULL)
+                    return (node_type(NULL, _alloc, _node_alloc));
+                return (extract(const_iterator(node)));
+            }
+
+            // the node of nh is linked in as it is if it comes from the same node
+            // allocator, otherwise its value is copied. nh is left empty when the
+            // element was inserted and keeps its node if the key was already there.
+            // A temporary handle comes in as a node_ref_type
+            ft::pair<iterator, bool>    insert(node_type &nh) {
+                if (nh.empty())
+                    return (ft::make_pair(end(), false));
+                if (!(nh._node_alloc == _node_alloc)) {
+                    ft::pair<iterator, bool>    ret = insert(nh.value());
+                    if (ret.second)
+                        nh._reset();
+                    return (ret);
                 }
+                ft::pair<Node *, bool>  ret = _insert_node(nh._node);
+                if (ret.second)
+                    nh._node = NULL;
+                return (ft::make_pair(iterator(ret.first), ret.second));
             }
 
+            ft::pair<iterator, bool>    insert(node_ref_type ref) {
+                return (insert(ref.handle));
+            }
+
+            iterator    insert(const_iterator hint, node_type &nh) {
+                if (nh.empty())
+                    return (end());
+                if (!(nh._node_alloc == _node_alloc)) {
+                    size_type   size = _size;
+                    iterator    ret = insert(iterator(const_cast<Node *>(hint.base())), nh.value());
+                    if (_size != size)
+                        nh._reset();
+                    return (ret);
+                }
+                Node    *node = nh._node;
+                Node    *ret = _insert_hint(const_cast<Node *>(hint.base()), node->data, node);
+                if (ret == node)
+                    nh._node = NULL;
+                return (iterator(ret));
+            }
+
+            iterator    insert(const_iterator hint, node_ref_type ref) {
+                return (insert(hint, ref.handle));
+            }
+
+            // moves the elements of source whose key is not in this tree yet.
+            // Nodes are relinked when both trees share the node allocator and
+            // source only holds greater keys is a single join
+            void    merge(RB_BST &source) {
+                if (&source == this || source._root == NULL)
+                    return ;
+                if (!(_node_alloc == source._node_alloc)) {
+                    for (iterator it = source.begin(); it != source.end();) {
+                        if (insert(*it).second)
+                            source.deleteNode(it++);
+                        else
+                            ++it;
+                    }
+                    return ;
+                }
+                if (_root == NULL || _cmp(_parent.right->data, source._leftmost->data)) {
+                    join(source);
+                    return ;
+                }
+                for (iterator it = source.begin(); it != source.end();) {
+                    Node    *node = (it++).base();
+                    Node    *pos;
+                    bool    left;
+                    if (_insert_position(node->data, pos, left) != NULL)
+                        continue ;
+                    source._unlink(node);
+                    source._size--;
+                    _link_at(pos, left, node);
+                }
+            }
+
+            // the headers stay where they are, only what hangs from them is swapped
             void    swap(RB_BST   &x) {
-                ft::swap(_parent.left, x._parent.left);
-                ft::swap(_root, x._root);
+                Node    *root = _root;
+                Node    *first = _leftmost;
+                Node    *last = _parent.right;
+                _adopt(x._root, x._leftmost, x._parent.right);
+                x._adopt(root, first, last);
                 ft::swap(_alloc, x._alloc);
                 ft::swap(_node_alloc, x._node_alloc);
                 ft::swap(_cmp, x._cmp);
                 ft::swap(_size, x._size);
-                _root->parent = &_parent;
-                x._root->parent = &x._parent;
             }
 
             void    clear() {
                 _clear(_root);
-                _parent.left = &_parent;
-                _root = NULL;
+                _adopt(NULL, NULL, NULL);
                 _size = 0;
             }
 
@@ -724,64 +1813,221 @@ template < class T,
             value_compare   value_comp() const { return _cmp; }
 
             /* --- Operations --- */
-            iterator    find(value_type const &key) {
-                Node    *res = _searchTreeHelper(_root, key);
-                if (res == NULL || !_equals(res->data, key))
+            iterator    find(key_type const &key) {
+                Node    *res = _find(key);
+                if (res == NULL)
                     return (end());
                 return(iterator(res));
             }
 
-            const_iterator  find(value_type const &key) const {
-                Node    *res = _searchTreeHelper(_root, key);
-                if (res == NULL || !_equals(res->data, key))
+            const_iterator  find(key_type const &key) const {
+                Node    *res = _find(key);
+                if (res == NULL)
                     return (end());
                 return(const_iterator(res));
             }
 
-            size_type   count(value_type const &key) const {
+            size_type   count(key_type const &key) const {
                 return (find(key) != end());
             }
 
-            iterator    lower_bound(value_type const &key) {
-                iterator    b = begin();
-                iterator    e = end();
-                while (b != e && !_equals(*b, key) && !_cmp(key, *b))
-                    ++b;
-                return b;
+            // writes find(key) to out for every key in [first, last)
+            template <class InputIterator, class OutputIterator>
+            OutputIterator  find_many(InputIterator first, InputIterator last, OutputIterator out) {
+                return (_find_many(first, last, out, end(), ft::iterator_category(first)));
+            }
+
+            template <class InputIterator, class OutputIterator>
+            OutputIterator  find_many(InputIterator first, InputIterator last, OutputIterator out) const {
+                return (_find_many(first, last, out, end(), ft::iterator_category(first)));
             }
 
-            const_iterator  lower_bound(value_type const &key) const {
-                const_iterator  b = begin();
-                const_iterator  e = end();
-                while (b != e && !_equals(*b, key) && !_cmp(key, *b))
-                    ++b;
-                return b;
+            iterator    lower_bound(key_type const &key) {
+                return (iterator(_lower_bound(_root, &_parent, key)));
             }
 
-            iterator    upper_bound(value_type const &key) {
-                reverse_iterator    rb = rbegin();
-                reverse_iterator    re = rend();
-                while (rb != re && !_equals(*rb, key) && _cmp(key, *rb))
-                    ++rb;
-                return rb.base();
+            const_iterator  lower_bound(key_type const &key) const {
+                return (const_iterator(_lower_bound(_root, const_cast<Node *>(&_parent), key)));
             }
 
-            const_iterator  upper_bound(value_type const &key) const {
-                const_reverse_iterator    rb = rbegin();
-                const_reverse_iterator    re = rend();
-                while (rb != re && !_equals(*rb, key) && _cmp(key, *rb))
-                    ++rb;
-                return rb.base();
+            iterator    upper_bound(key_type const &key) {
+                return (iterator(_upper_bound(_root, &_parent, key)));
             }
 
-            ft::pair<const_iterator, const_iterator>    equal_range(value_type const &key) const {
-                return ft::make_pair(lower_bound(key), upper_bound(key));
+            const_iterator  upper_bound(key_type const &key) const {
+                return (const_iterator(_upper_bound(_root, const_cast<Node *>(&_parent), key)));
             }
 
-            ft::pair<iterator, iterator>    equal_range(value_type const &key) {
-                return ft::make_pair(lower_bound(key), upper_bound(key));
+            ft::pair<const_iterator, const_iterator>    equal_range(key_type const &key) const {
+                ft::pair<Node *, Node *>    res = _equal_range(key);
+                return ft::make_pair(const_iterator(res.first), const_iterator(res.second));
             }
 
+            ft::pair<iterator, iterator>    equal_range(key_type const &key) {
+                ft::pair<Node *, Node *>    res = _equal_range(key);
+                return ft::make_pair(iterator(res.first), iterator(res.second));
+            }
+
+            /* --- Order statistics --- */
+            // number of elements less than key
+            size_type   rank(key_type const &key) const {
+# ifdef FT_ORDER_STATISTICS
+                size_type   ret = 0;
+                for (Node *node = _root; node != NULL;) {
+                    if (_cmp(node->data, key)) {
+                        ret += tree_subtree_size(node->left) + 1;
+                        node = node->right;
+                    }
+                    else
+                        node = node->left;
+                }
+                return (ret);
+# else
+                return (ft::distance(begin(), lower_bound(key)));
+# endif
+            }
+
+            // k-th smallest element (counting from 0), end() if k >= size()
+            iterator    select(size_type k) {
+                return (iterator(_select(k)));
+            }
+
+            const_iterator  select(size_type k) const {
+                return (const_iterator(_select(k)));
+            }
+
+            // number of elements in [lo, hi]
+            size_type   count_range(key_type const &lo, key_type const &hi) const {
+                const_iterator  first = lower_bound(lo);
+                if (first == end() || _cmp(hi, *first))
+                    return (0);
+                return (ft::distance(first, upper_bound(hi)));
+            }
+
+            /* --- Set operations --- */
+            // out receives the elements of this tree, other, or both, see below.
+            // Both trees have to be ordered the same way, out may be one of them
+            void    set_union(RB_BST const &other, RB_BST &out) const {
+                _set_operation(other, out, _UNION);
+            }
+
+            // elements in both trees
+            void    set_intersection(RB_BST const &other, RB_BST &out) const {
+                _set_operation(other, out, _INTERSECTION);
+            }
+
+            // elements of this tree that are not in other
+            void    set_difference(RB_BST const &other, RB_BST &out) const {
+                _set_operation(other, out, _DIFFERENCE);
+            }
+
+            // elements in exactly one of the trees
+            void    set_symmetric_difference(RB_BST const &other, RB_BST &out) const {
+                _set_operation(other, out, _SYMMETRIC_DIFFERENCE);
+            }
+
+            /* --- Split and join --- */
+# ifdef FT_ORDER_STATISTICS
+            // keeps the elements less than key and moves all others into right,
+            // whose previous content is dropped. No element is copied
+            void    split(key_type const &key, RB_BST &right) {
+                if (&right == this)
+                    return ;
+                _split_tree(key, false, right);
+            }
+# endif
+
+            // moves every element of right to the end of this tree in O(log n).
+            // If right holds keys that are not greater than ours, or its nodes
+            // come from another allocator, its elements are inserted instead
+            void    join(RB_BST &right) {
+                if (&right == this || right._root == NULL)
+                    return ;
+                if (_root != NULL && (!(_node_alloc == right._node_alloc)
+                    || !_cmp(_parent.right->data, right._leftmost->data))) {
+                    insert(right.begin(), right.end());
+                    right.clear();
+                    return ;
+                }
+                if (_root == NULL) {
+                    clear();
+                    _node_alloc = right._node_alloc;
+                    _alloc = right._alloc;
+                }
+                Node    *k = right._leftmost;
+                right._unlink(k);
+                size_type   lh = _black_height(_root);
+                size_type   rh = _black_height(right._root);
+                size_type   h;
+                _set_root(_join(_root, lh, k, right._root, rh, h));
+                _size += right._size;
+                right._set_root(NULL);
+                right._size = 0;
+            }
+
+# ifdef FT_ORDER_STATISTICS
+            // moves the elements in [lo, hi] into out, whose previous content is dropped
+            void    extract_range(key_type const &lo, key_type const &hi, RB_BST &out) {
+                if (&out == this)
+                    return ;
+                RB_BST  tail(_cmp, _alloc);
+                _split_tree(lo, false, out);
+                out._split_tree(hi, true, tail);
+                join(tail);
+            }
+# endif
+
+            /* --- Cursors --- */
+            // A cursor remembers a position in the tree and starts its searches
+            // from there, so work on keys close to the previous one does not
+            // descend from the root again. Erasing the element under a cursor by
+            // other means invalidates it.
+            template <class Iterator>
+            class basic_cursor {
+                RB_BST  *_tree;
+                Node    *_node;
+
+                public:
+                    basic_cursor(RB_BST &tree, Iterator pos)
+                        : _tree(&tree), _node(const_cast<Node *>(pos.base())) { }
+
+                    Iterator    position() const { return (Iterator(_node)); }
+
+                    // moves to the first element not less than key, true if it is equal to key
+                    bool    seek(key_type const &key) {
+                        _node = _tree->_lower_bound_from(_node, key);
+                        return (_node != &_tree->_parent && !_tree->_cmp(key, _node->data));
+                    }
+
+                    // inserts val unless an equal element exists, the cursor moves to
+                    // the inserted or the existing element
+                    ft::pair<Iterator, bool>    insert_near(value_type const &val) {
+                        Node    *pos = _tree->_lower_bound_from(_node, val);
+                        if (pos != &_tree->_parent && !_tree->_cmp(val, pos->data)) {
+                            _node = pos;
+                            return (ft::make_pair(Iterator(pos), false));
+                        }
+                        _node = _tree->_insert_hint(pos, val);
+                        return (ft::make_pair(Iterator(_node), true));
+                    }
+
+                    // erases the element under the cursor, which moves on to the next one.
+                    // At end() there is nothing to erase and nothing happens
+                    void    erase_here() {
+                        if (_node == &_tree->_parent)
+                            return ;
+                        Node    *next = _tree->_successor(_node);
+                        _tree->_deleteNode(_node);
+                        _tree->_size--;
+                        _node = next;
+                    }
+            };
+
+            template <class Iterator>
+                friend class basic_cursor;
+
+            typedef basic_cursor<iterator>  cursor;
+
             void    prettyPrint() {
                 _printTreeHelper(_root, "", true);
             }
@@ -13,8 +13,22 @@
 #ifndef TREENODE_HPP
 # define TREENODE_HPP
 
+# include <cstddef>
+
 enum tree_color { RED = false, BLACK = true };
 
+// Parent and color are only accessed through get_/set_ so the layout can change.
+// Compiling with -D FT_COMPACT_NODE stores the color in the lowest bit of the
+// parent pointer (nodes are at least pointer aligned, so the bit is always free)
+// and saves the separate color field and its padding.
+// In both layouts the links come first, so they share a cache line with the data.
+//
+// Compiling with -D FT_ORDER_STATISTICS adds the size of the subtree rooted at
+// each node, which the tree keeps up to date. It makes rank, select and
+// iterator advance/distance O(log n).
+
+# ifndef FT_COMPACT_NODE
+
 template <class T>
     struct tree_node {
 
@@ -23,8 +37,157 @@ template <class T>
         tree_node   *parent;
         tree_node   *left;
         tree_node   *right;
+        tree_color  color;
+#  ifdef FT_ORDER_STATISTICS
+        size_t      size;
+#  endif
+        value_type  data;
+
+        tree_node   *get_parent() const { return parent; }
+        void        set_parent(tree_node *p) { parent = p; }
+        tree_color  get_color() const { return color; }
+        void        set_color(tree_color c) { color = c; }
+    };
+
+# else
+
+template <class T>
+    struct tree_node {
+
+        typedef T   value_type;
+
+        size_t      parent_color;
+        tree_node   *left;
+        tree_node   *right;
+#  ifdef FT_ORDER_STATISTICS
+        size_t      size;
+#  endif
         value_type  data;
+
+        tree_node   *get_parent() const {
+            return reinterpret_cast<tree_node *>(parent_color & ~static_cast<size_t>(1));
+        }
+
+        void        set_parent(tree_node *p) {
+            parent_color = reinterpret_cast<size_t>(p) | (parent_color & 1);
+        }
+
+        tree_color  get_color() const {
+            return static_cast<tree_color>(parent_color & 1);
+        }
+
+        void        set_color(tree_color c) {
+            parent_color = (parent_color & ~static_cast<size_t>(1)) | static_cast<size_t>(c);
+        }
+    };
+
+# endif
+
+// The default layout, which is also the node of std::map and std::set. max_size()
+// is computed from it, so the layout flags above do not change it.
+template <class T>
+    struct tree_node_plain {
+        void        *parent;
+        void        *left;
+        void        *right;
         tree_color  color;
+        T           data;
     };
 
+// Compiling with -D FT_PREFETCH makes lookups request both children of a node
+// from memory while the node is compared, and iterators request the first node
+// on the way to the next element while the caller works on the current one.
+// Without it the hints compile to nothing.
+
+template <class Node>
+    inline void tree_prefetch(Node const *node) {
+# ifdef FT_PREFETCH
+        __builtin_prefetch(node);
+# else
+        (void)node;
+# endif
+    }
+
+// the in-order successor of node is below its right child or above it
+template <class Node>
+    inline void tree_prefetch_next(Node const *node) {
+# ifdef FT_PREFETCH
+        if (node != NULL)
+            tree_prefetch(node->right != NULL ? node->right : node->get_parent());
+# else
+        (void)node;
+# endif
+    }
+
+template <class Node>
+    inline void tree_prefetch_prev(Node const *node) {
+# ifdef FT_PREFETCH
+        if (node != NULL)
+            tree_prefetch(node->left != NULL ? node->left : node->get_parent());
+# else
+        (void)node;
+# endif
+    }
+
+# ifdef FT_ORDER_STATISTICS
+
+// The helpers below work on any node of a tree, including the header node
+// that serves as end(). The header is the only node without a parent and its
+// left link points to the root (or to itself when the tree is empty).
+
+template <class Node>
+    size_t  tree_subtree_size(Node *node) {
+        return (node ? node->size : 0);
+    }
+
+template <class Node>
+    Node    *tree_header(Node *node) {
+        while (node->get_parent() != NULL)
+            node = node->get_parent();
+        return (node);
+    }
+
+// number of nodes before node in in-order, end() has the size of the tree
+template <class Node>
+    size_t  tree_rank(Node *node) {
+        if (node->get_parent() == NULL)
+            return (node->left == node ? 0 : tree_subtree_size(node->left));
+        size_t  rank = tree_subtree_size(node->left);
+        while (node->get_parent()->get_parent() != NULL) {
+            Node    *parent = node->get_parent();
+            if (parent->right == node)
+                rank += tree_subtree_size(parent->left) + 1;
+            node = parent;
+        }
+        return (rank);
+    }
+
+// node with rank k in the tree of header, header itself if k is out of range
+template <class Node>
+    Node    *tree_select(Node *header, size_t k) {
+        Node    *node = header->left;
+        if (node == header || k >= node->size)
+            return (header);
+        while (true) {
+            size_t  left = tree_subtree_size(node->left);
+            if (k == left)
+                return (node);
+            if (k < left)
+                node = node->left;
+            else {
+                k -= left + 1;
+                node = node->right;
+            }
+        }
+    }
+
+template <class Node>
+    Node    *tree_advance(Node *node, long n) {
+        if (node == NULL)
+            return (node);
+        return (tree_select(tree_header(node), tree_rank(node) + n));
+    }
+
+# endif
+
 #endif
\ No newline at end of file
@@ -13,6 +13,12 @@
 #ifndef TYPETRAITS_HPP
 # define TYPETRAITS_HPP
 
+// Compiling with -std=c++11 or later adds move semantics and emplace to the
+// containers. The C++98 build is left as it is.
+# if __cplusplus >= 201103L
+#  define FT_CXX11
+# endif
+
 namespace ft {
 
 template<bool Cond, class T = void>
@@ -62,5 +68,52 @@ template <>
 template <>
 	struct is_integral<unsigned long long int>: public true_type { };
 
+template <class T>
+	struct is_floating_point: public false_type {};
+
+template <>
+	struct is_floating_point<float>: public true_type { };
+template <>
+	struct is_floating_point<double>: public true_type { };
+template <>
+	struct is_floating_point<long double>: public true_type { };
+
+template <class T>
+	struct is_arithmetic: public integral_constant<bool,
+		is_integral<T>::value || is_floating_point<T>::value> { };
+
+template <class T, class U>
+	struct is_same: public false_type { };
+
+template <class T>
+	struct is_same<T, T>: public true_type { };
+
+template <class T>
+	struct remove_const {
+		typedef T	type;
+	};
+
+template <class T>
+	struct remove_const<const T> {
+		typedef T	type;
+	};
+
+template <class T>
+	struct is_pointer: public false_type { };
+
+template <class T>
+	struct is_pointer<T *>: public true_type { };
+
+// Elements that can be copied with memcpy / memmove. Where the compiler does
+// not tell, only arithmetic types and pointers are known to be safe.
+template <class T>
+	struct is_trivially_copyable: public integral_constant<bool,
+# if defined(__GNUC__) || defined(__clang__)
+		__is_trivially_copyable(T)
+# else
+		is_arithmetic<T>::value || is_pointer<T>::value
+# endif
+		> { };
+
 } // ft
 #endif // TYPETRAITS_HPP
\ No newline at end of file
@@ -13,7 +13,16 @@
 #ifndef UTILS_HPP
 # define UTILS_HPP
 
+# include <cstring>
+# include <memory>
+# include <new>
+# include <string>
 # include "../iterators/iterator_traits.hpp"
+# include "TypeTraits.hpp"
+# ifdef FT_CXX11
+#  include <type_traits>
+#  include <utility>
+# endif
 
 namespace ft {
 
@@ -36,41 +45,81 @@ template <class _RandIter>
 
 template<typename iterator>
 	typename iterator_traits<iterator>::difference_type distance(iterator first, iterator last) {
-		typename ft::iterator_traits<iterator>::difference_type	count = 0;
-		for (; first != last;) {
-			++count;
-			++first;
-		}
-		return (count);
+		return (ft::_distance(first, last, ft::iterator_category(first)));
+	}
+
+template <class _InputIter, class _Distance>
+	void	_advance(_InputIter &it, _Distance n, input_iterator_tag) {
+		for (; n > 0; --n)
+			++it;
+	}
+
+template <class _BiIter, class _Distance>
+	void	_advance(_BiIter &it, _Distance n, bidirectional_iterator_tag) {
+		for (; n > 0; --n)
+			++it;
+		for (; n < 0; ++n)
+			--it;
+	}
+
+template <class _RandIter, class _Distance>
+	void	_advance(_RandIter &it, _Distance n, random_access_iterator_tag) {
+		it += n;
 	}
 
+template<typename iterator, typename Distance>
+	void	advance(iterator &it, Distance n) {
+		ft::_advance(it, n, ft::iterator_category(it));
+	}
+
+// Random access ranges are walked with a count, which spares the comparison
+// of two iterators on every step and lets the compiler unroll the loop.
+
 template<typename iterator, typename InputIterator>
-	iterator	copy(InputIterator first, InputIterator last, iterator position) {
-		while (first != last)
-		{
+	iterator	_copy(InputIterator first, InputIterator last, iterator position, input_iterator_tag) {
+		for (; first != last; ++first, ++position)
+			*position = *first;
+		return (position);
+	}
+
+template<typename iterator, typename InputIterator>
+	iterator	_copy(InputIterator first, InputIterator last, iterator position, random_access_iterator_tag) {
+		for (typename iterator_traits<InputIterator>::difference_type n = last - first; n > 0; --n) {
 			*position = *first;
 			++first;
 			++position;
 		}
-		return(position);
+		return (position);
 	}
 
 template<typename iterator, typename InputIterator>
-	iterator	copy_backward(InputIterator first, InputIterator last, iterator position) {
-		--first;
-		--last;
-		size_t	n = ft::distance<InputIterator>(first, last);
-		position = position + n - 1;
-		while (last != first) {
-			*position = *last;
-			last--;
-			position--;
-		}
-		return (position + n);
+	iterator	copy(InputIterator first, InputIterator last, iterator position) {
+		return (ft::_copy(first, last, position, ft::iterator_category(first)));
+	}
+
+// Like std::copy_backward: copies [first, last) to the range ending at
+// result, last element first, and returns the start of the copy.
+template<typename iterator, typename BidirIterator>
+	iterator	_copy_backward(BidirIterator first, BidirIterator last, iterator result, bidirectional_iterator_tag) {
+		while (first != last)
+			*--result = *--last;
+		return (result);
+	}
+
+template<typename iterator, typename BidirIterator>
+	iterator	_copy_backward(BidirIterator first, BidirIterator last, iterator result, random_access_iterator_tag) {
+		for (typename iterator_traits<BidirIterator>::difference_type n = last - first; n > 0; --n)
+			*--result = *--last;
+		return (result);
+	}
+
+template<typename iterator, typename BidirIterator>
+	iterator	copy_backward(BidirIterator first, BidirIterator last, iterator result) {
+		return (ft::_copy_backward(first, last, result, ft::iterator_category(first)));
 	}
 
 template<typename iterator, typename InputIterator>
-	iterator	uninitialized_copy(InputIterator first, InputIterator last, iterator result) {
+	iterator	_uninitialized_copy(InputIterator first, InputIterator last, iterator result, input_iterator_tag) {
 		for (; first != last; ++result, ++first) {
 			new (static_cast<void *>(&*result))
 				typename ft::iterator_traits<iterator>::value_type(*first);
@@ -78,6 +127,258 @@ template<typename iterator, typename InputIterator>
 		return result;
 	}
 
+template<typename iterator, typename InputIterator>
+	iterator	_uninitialized_copy(InputIterator first, InputIterator last, iterator result, random_access_iterator_tag) {
+		for (typename iterator_traits<InputIterator>::difference_type n = last - first; n > 0; --n, ++result, ++first) {
+			new (static_cast<void *>(&*result))
+				typename ft::iterator_traits<iterator>::value_type(*first);
+		}
+		return result;
+	}
+
+template<typename iterator, typename InputIterator>
+	iterator	uninitialized_copy(InputIterator first, InputIterator last, iterator result) {
+		return (ft::_uninitialized_copy(first, last, result, ft::iterator_category(first)));
+	}
+
+// Pointers to trivially copyable elements are copied in bulk with memmove
+// (memcpy into uninitialized memory, which cannot overlap the source).
+// The overloads below are picked over the generic ones for pointer arguments.
+
+template <class T>
+	T	*_copy(T const *first, T const *last, T *result, true_type) {
+		size_t	n = last - first;
+		if (n)
+			std::memmove(result, first, n * sizeof(T));
+		return (result + n);
+	}
+
+template <class T>
+	T	*_copy(T const *first, T const *last, T *result, false_type) {
+		for (; first != last; ++first, ++result)
+			*result = *first;
+		return (result);
+	}
+
+template <class T>
+	T	*copy(T const *first, T const *last, T *result) {
+		return (_copy(first, last, result, integral_constant<bool, is_trivially_copyable<T>::value>()));
+	}
+
+template <class T>
+	T	*copy(T *first, T *last, T *result) {
+		return (ft::copy(const_cast<T const *>(first), const_cast<T const *>(last), result));
+	}
+
+template <class T>
+	T	*_copy_backward(T const *first, T const *last, T *result, true_type) {
+		size_t	n = last - first;
+		if (n)
+			std::memmove(result - n, first, n * sizeof(T));
+		return (result - n);
+	}
+
+template <class T>
+	T	*_copy_backward(T const *first, T const *last, T *result, false_type) {
+		while (first != last)
+			*--result = *--last;
+		return (result);
+	}
+
+template <class T>
+	T	*copy_backward(T const *first, T const *last, T *result) {
+		return (_copy_backward(first, last, result, integral_constant<bool, is_trivially_copyable<T>::value>()));
+	}
+
+template <class T>
+	T	*copy_backward(T *first, T *last, T *result) {
+		return (ft::copy_backward(const_cast<T const *>(first), const_cast<T const *>(last), result));
+	}
+
+template <class T>
+	T	*_uninitialized_copy(T const *first, T const *last, T *result, true_type) {
+		size_t	n = last - first;
+		if (n)
+			std::memcpy(result, first, n * sizeof(T));
+		return (result + n);
+	}
+
+template <class T>
+	T	*_uninitialized_copy(T const *first, T const *last, T *result, false_type) {
+		for (; first != last; ++result, ++first)
+			new (static_cast<void *>(result)) T(*first);
+		return (result);
+	}
+
+template <class T>
+	T	*uninitialized_copy(T const *first, T const *last, T *result) {
+		return (_uninitialized_copy(first, last, result, integral_constant<bool, is_trivially_copyable<T>::value>()));
+	}
+
+template <class T>
+	T	*uninitialized_copy(T *first, T *last, T *result) {
+		return (ft::uninitialized_copy(const_cast<T const *>(first), const_cast<T const *>(last), result));
+	}
+
+// Types that own their content through a pointer, whose default constructor
+// neither allocates nor throws and whose member swap exchanges contents in
+// O(1). ft::swap calls their member swap, and in C++98 the vector relocates
+// them by default constructing the destination and swapping it with the
+// source instead of copying. The containers opt in for the default
+// allocator, other types do by specializing the trait:
+//
+//     template <>
+//         struct has_cheap_swap<my_type> : public true_type { };
+template <class T>
+	struct has_cheap_swap : public false_type { };
+
+template <class C, class Tr>
+	struct has_cheap_swap<std::basic_string<C, Tr, std::allocator<C> > > : public true_type { };
+
+// Whether default constructing a T neither allocates nor throws. The header
+// node of a map or set holds a default constructed value, so they only have
+// a cheap swap when their elements have this.
+template <class T>
+	struct has_cheap_default : public integral_constant<bool,
+		is_arithmetic<T>::value || is_pointer<T>::value || has_cheap_swap<T>::value> { };
+
+// Moving elements inside a vector or into new storage. With C++11 the
+// elements are moved. Growing into new storage moves them only when that
+// cannot throw (or they cannot be copied), so a failed move never leaves the
+// old storage half emptied. In C++98 these copy, or swap when has_cheap_swap
+// holds. Either way the elements moved from are left empty, so a value that
+// may be one of them has to be copied before they are moved.
+
+# ifdef FT_CXX11
+
+template <class T>
+	T	*_move_range(T *first, T *last, T *result, true_type) {
+		return (ft::copy(first, last, result));
+	}
+
+template <class T>
+	T	*_move_range(T *first, T *last, T *result, false_type) {
+		for (; first != last; ++first, ++result)
+			*result = std::move(*first);
+		return (result);
+	}
+
+template <class T>
+	T	*move_range(T *first, T *last, T *result) {
+		return (_move_range(first, last, result, integral_constant<bool, is_trivially_copyable<T>::value>()));
+	}
+
+template <class T>
+	T	*_move_range_backward(T *first, T *last, T *result, true_type) {
+		return (ft::copy_backward(first, last, result));
+	}
+
+template <class T>
+	T	*_move_range_backward(T *first, T *last, T *result, false_type) {
+		while (first != last)
+			*--result = std::move(*--last);
+		return (result);
+	}
+
+template <class T>
+	T	*move_range_backward(T *first, T *last, T *result) {
+		return (_move_range_backward(first, last, result, integral_constant<bool, is_trivially_copyable<T>::value>()));
+	}
+
+template <class T>
+	T	*_uninitialized_move(T *first, T *last, T *result, true_type) {
+		return (ft::uninitialized_copy(first, last, result));
+	}
+
+template <class T>
+	T	*_uninitialized_move(T *first, T *last, T *result, false_type) {
+		for (; first != last; ++result, ++first)
+			new (static_cast<void *>(result)) T(std::move(*first));
+		return (result);
+	}
+
+template <class T>
+	T	*uninitialized_move(T *first, T *last, T *result) {
+		return (_uninitialized_move(first, last, result, integral_constant<bool, is_trivially_copyable<T>::value>()));
+	}
+
+template <class T>
+	T	*_uninitialized_move_if_noexcept(T *first, T *last, T *result, true_type) {
+		return (ft::uninitialized_move(first, last, result));
+	}
+
+template <class T>
+	T	*_uninitialized_move_if_noexcept(T *first, T *last, T *result, false_type) {
+		return (ft::uninitialized_copy(first, last, result));
+	}
+
+template <class T>
+	T	*uninitialized_move_if_noexcept(T *first, T *last, T *result) {
+		return (_uninitialized_move_if_noexcept(first, last, result, integral_constant<bool,
+			std::is_nothrow_move_constructible<T>::value || !std::is_copy_constructible<T>::value>()));
+	}
+
+# else
+
+template <class T>
+	T	*_move_range(T *first, T *last, T *result, true_type) {
+		for (; first != last; ++first, ++result)
+			result->swap(*first);
+		return (result);
+	}
+
+template <class T>
+	T	*_move_range(T *first, T *last, T *result, false_type) {
+		return (ft::copy(first, last, result));
+	}
+
+template <class T>
+	T	*move_range(T *first, T *last, T *result) {
+		return (_move_range(first, last, result, integral_constant<bool, has_cheap_swap<T>::value>()));
+	}
+
+template <class T>
+	T	*_move_range_backward(T *first, T *last, T *result, true_type) {
+		while (first != last)
+			(--result)->swap(*--last);
+		return (result);
+	}
+
+template <class T>
+	T	*_move_range_backward(T *first, T *last, T *result, false_type) {
+		return (ft::copy_backward(first, last, result));
+	}
+
+template <class T>
+	T	*move_range_backward(T *first, T *last, T *result) {
+		return (_move_range_backward(first, last, result, integral_constant<bool, has_cheap_swap<T>::value>()));
+	}
+
+template <class T>
+	T	*_uninitialized_move(T *first, T *last, T *result, true_type) {
+		for (; first != last; ++result, ++first)
+			(new (static_cast<void *>(result)) T())->swap(*first);
+		return (result);
+	}
+
+template <class T>
+	T	*_uninitialized_move(T *first, T *last, T *result, false_type) {
+		return (ft::uninitialized_copy(first, last, result));
+	}
+
+template <class T>
+	T	*uninitialized_move(T *first, T *last, T *result) {
+		return (_uninitialized_move(first, last, result, integral_constant<bool, has_cheap_swap<T>::value>()));
+	}
+
+// nothing can throw once the destination is allocated
+template <class T>
+	T	*uninitialized_move_if_noexcept(T *first, T *last, T *result) {
+		return (ft::uninitialized_move(first, last, result));
+	}
+
+# endif
+
 template<typename iterator, typename T>
 	void fill(iterator first, iterator last, const T& val) {
 		while (first != last) {
@@ -95,12 +396,22 @@ template<typename iterator, typename Size, typename T>
 	}
 
 template<typename T>
-	void	swap(T &first, T &second) {
+	void	_swap(T &first, T &second, true_type) {
+		first.swap(second);
+	}
+
+template<typename T>
+	void	_swap(T &first, T &second, false_type) {
 		T	tmp = first;
 		first = second;
 		second = tmp;
 	}
 
+template<typename T>
+	void	swap(T &first, T &second) {
+		_swap(first, second, integral_constant<bool, has_cheap_swap<T>::value>());
+	}
+
 } // namespace ft
 
 #endif
\ No newline at end of file
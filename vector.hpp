@@ -92,9 +92,7 @@ template <class T, class Alloc = std::allocator<T> >
 					size_type	old_cap = _cap;
 					size_type	new_size = _recommend_size(old_size + n);
 					pointer		tmp = _alloc.allocate(new_size);
-					for (size_type i = 0; i < old_size; ++i) {
-						_alloc.construct(tmp + i, *(_begin + i));
-					}
+					ft::uninitialized_move_if_noexcept(_begin, _end, tmp);
 					for (size_type i = old_size; i < old_size + n; ++i) {
 						_alloc.construct(tmp + i, val);
 					}
@@ -105,11 +103,20 @@ template <class T, class Alloc = std::allocator<T> >
 				}
 			}
 
+			// val may be an element of the vector, so it is copied before the
+			// elements are moved (which leaves them empty) and built in the new
+			// storage before the old one is emptied
 			void	_insert_helper(iterator position, const T &val) {
+				pointer	p = position.base();
 				if (_end != _begin + _cap) {
-					_alloc.construct(_end, *(_end - 1));
-					ft::copy_backward(position, end() - 1, position + 1);
-					*position = val;
+					value_type	copy(val);
+					ft::uninitialized_move(_end - 1, _end, _end);
+					ft::move_range_backward(p, _end - 1, _end);
+# ifdef FT_CXX11
+					*p = std::move(copy);
+# else
+					*p = copy;
+# endif
 					++_end;
 				}
 				else {
@@ -118,20 +125,143 @@ template <class T, class Alloc = std::allocator<T> >
 						n = _recommend_size(size() + 1);
 					else
 						n = 10;
+					size_type	old_size = size();
 					pointer	tmp = _alloc.allocate(n);
-					iterator	it(tmp);
-					ft::copy(begin(), position, it);
-					_alloc.construct(tmp + (position - begin()), val);
-					ft::uninitialized_copy(position, end(), tmp + (position - begin()) + 1);
+					_alloc.construct(tmp + (p - _begin), val);
+					ft::uninitialized_move_if_noexcept(_begin, p, tmp);
+					ft::uninitialized_move_if_noexcept(p, _end, tmp + (p - _begin) + 1);
 					for (pointer tmp = _begin; tmp != _end; ++tmp)
 						_destroy(_alloc, tmp);
 					_alloc.deallocate(_begin, _cap);
 					_cap = n;
-					_end = tmp + size() + 1;
+					_end = tmp + old_size + 1;
 					_begin = tmp;
 				}
 			}
 
+			// Sources that can only be read once are read in a single pass: the
+			// elements are appended and the vector grows geometrically. Sources
+			// that can be walked again are measured first, so the storage is
+			// allocated once and the elements are constructed in bulk.
+			template <class InputIterator>
+				void	_range_init(InputIterator first, InputIterator last, ft::input_iterator_tag) {
+					for (; first != last; ++first)
+						push_back(*first);
+				}
+
+			template <class ForwardIterator>
+				void	_range_init(ForwardIterator first, ForwardIterator last, ft::forward_iterator_tag) {
+					size_type	n = ft::distance(first, last);
+					if (n > max_size())
+						throw std::length_error("vector");
+					_begin = _alloc.allocate(n);
+					_cap = n;
+					_end = ft::uninitialized_copy(first, last, _begin);
+				}
+
+			// assigns over the current elements before appending the rest
+			template <class InputIterator>
+				void	_assign_range(InputIterator first, InputIterator last, ft::input_iterator_tag) {
+					pointer	cur = _begin;
+					for (; first != last && cur != _end; ++first, ++cur)
+						*cur = *first;
+					if (first == last)
+						_destruct_at_end(cur);
+					for (; first != last; ++first)
+						push_back(*first);
+				}
+
+			template <class ForwardIterator>
+				void	_assign_range(ForwardIterator first, ForwardIterator last, ft::forward_iterator_tag) {
+					size_type	n = ft::distance(first, last);
+					if (n > max_size())
+						throw std::length_error("vector");
+					if (n > _cap) {
+						clear();
+						_alloc.deallocate(_begin, _cap);
+						_cap = n;
+						_begin = _alloc.allocate(_cap);
+						_end = ft::uninitialized_copy(first, last, _begin);
+					}
+					else if (size() >= n) {
+						_destruct_at_end(ft::copy(first, last, _begin));
+					}
+					else {
+						ForwardIterator	mid = first;
+						ft::advance(mid, size());
+						ft::copy(first, mid, _begin);
+						_end = ft::uninitialized_copy(mid, last, _end);
+					}
+				}
+
+			// appends the new elements and rotates them into place
+			template <class InputIterator>
+				void	_insert_range(pointer p, InputIterator first, InputIterator last, ft::input_iterator_tag) {
+					size_type	off = p - _begin;
+					size_type	old_size = size();
+					for (; first != last; ++first)
+						push_back(*first);
+					std::rotate(_begin + off, _begin + old_size, _end);
+				}
+
+			template <class ForwardIterator>
+				void	_insert_range(pointer p, ForwardIterator first, ForwardIterator last, ft::forward_iterator_tag) {
+					if (first == last)
+						return;
+					size_type n = 0;
+					n = ft::distance(first, last);
+					if (n > max_size() || size() + n > max_size())
+						throw std::length_error("vector");
+					if ((_begin + _cap) - _end >= static_cast<long>(n)) {
+						size_type	after = _end - p;
+						if (after > n) {
+							ft::uninitialized_move(_end - n, _end, _end);
+							ft::move_range_backward(p, _end - n, _end);
+							ft::copy(first, last, p);
+						}
+						else {
+							ForwardIterator	mid = first;
+							ft::advance(mid, after);
+							ft::uninitialized_move(p, _end, p + n);
+							ft::copy(first, mid, p);
+							ft::uninitialized_copy(mid, last, _end);
+						}
+						_end += n;
+					}
+					else {
+						size_type	old_size = size();
+						size_type len = old_size + std::max(old_size, n);
+						pointer	tmp = _alloc.allocate(len);
+						ft::uninitialized_move_if_noexcept(_begin, p, tmp);
+						ft::uninitialized_copy(first, last, tmp + (p - _begin));
+						ft::uninitialized_move_if_noexcept(p, _end, tmp + (p - _begin + n));
+						for (pointer tmp2 = _begin; tmp2 != _end; ++tmp2)
+							_destroy(_alloc, tmp2);
+						_alloc.deallocate(_begin, _cap);
+						_cap = len;
+						_end = tmp + old_size + n;
+						_begin = tmp;
+					}
+				}
+
+# ifdef FT_CXX11
+			// the new element is built first, args may refer to an element
+			// that is still in the old storage
+			template <class... Args>
+				void	_realloc_emplace(pointer p, Args&&... args) {
+					size_type	old_size = size();
+					size_type	new_cap = _recommend_size(old_size + 1);
+					pointer		tmp = _alloc.allocate(new_cap);
+					new (static_cast<void *>(tmp + (p - _begin))) value_type(std::forward<Args>(args)...);
+					ft::uninitialized_move_if_noexcept(_begin, p, tmp);
+					ft::uninitialized_move_if_noexcept(p, _end, tmp + (p - _begin) + 1);
+					_delete(_cap);
+					_begin = tmp;
+					_end = tmp + old_size + 1;
+					_cap = new_cap;
+				}
+# endif
+
 		public:
 
 		/* ----------- Constructors, Destructor, Assignment Operator Overload ----------- */
@@ -152,20 +282,21 @@ template <class T, class Alloc = std::allocator<T> >
 			vector(InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type(),
 				typename ft::enable_if<!ft::is_integral<InputIterator>::value, bool>::type = true) :
 				_alloc(alloc), _begin(NULL), _end(NULL), _cap(0) {
-					difference_type n = ft::distance(first, last);
-					reserve(n);
-					_end = _begin + n;
-					ft::copy(first, last, iterator(_begin));
+					_range_init(first, last, ft::iterator_category(first));
 			}
 
 		vector(const vector& x) : _alloc(x._alloc), _begin(NULL), _end(NULL), _cap(x._cap) {
 			_begin = _alloc.allocate(_cap);
-			_end = _begin;
-			for (size_t i = 0; i < x.size(); ++i) {
-				_alloc.construct(_end, x[i]);
-				_end++;
-			}
+			_end = ft::uninitialized_copy(x._begin, x._end, _begin);
+		}
+
+# ifdef FT_CXX11
+		vector(vector&& x) noexcept : _alloc(x._alloc), _begin(x._begin), _end(x._end), _cap(x._cap) {
+			x._begin = NULL;
+			x._end = NULL;
+			x._cap = 0;
 		}
+# endif
 
 		~vector(void) {
 			clear();
@@ -178,25 +309,36 @@ template <class T, class Alloc = std::allocator<T> >
 			if (x.size() > _cap) {
 				clear();
 				_alloc.deallocate(_begin, _cap);
-				_cap = x.end() - x.begin();
+				_cap = x.size();
 				_begin = _alloc.allocate(_cap);
-				ft::copy(x.begin(), x.end(), begin());
-				_end = _begin + x.size();
+				_end = ft::uninitialized_copy(x._begin, x._end, _begin);
 			}
 			else if (size() >= x.size()) {
-				size_type x_n = x.size();
-				iterator i = ft::copy(x.begin(), x.end(), begin());
-				for (; i != end(); ++i, ++x_n) {
-					_alloc.destroy(_begin + x_n);
-				}
+				_destruct_at_end(ft::copy(x._begin, x._end, _begin));
 			}
 			else {
-				ft::copy(x.begin(), x.end(), begin());
+				ft::copy(x._begin, x._begin + size(), _begin);
+				_end = ft::uninitialized_copy(x._begin + size(), x._end, _end);
 			}
-			_end = _begin + x.size();
 			return (*this);
 		}
 
+# ifdef FT_CXX11
+		vector	&operator=(vector&& x) noexcept {
+			if (&x == this)
+				return (*this);
+			clear();
+			_alloc.deallocate(_begin, _cap);
+			_begin = x._begin;
+			_end = x._end;
+			_cap = x._cap;
+			x._begin = NULL;
+			x._end = NULL;
+			x._cap = 0;
+			return (*this);
+		}
+# endif
+
 		/* ----------- Iterators ----------- */
 		iterator				begin(void) {
 			return (iterator(_begin));
@@ -261,13 +403,14 @@ template <class T, class Alloc = std::allocator<T> >
 				throw std::length_error("vector");
 			else if (n > _cap) {
 				size_type	new_size = n;
+				size_type	old_size = size();
 				pointer	tmp = _alloc.allocate(new_size);
-				ft::copy(begin(), end(), tmp);
+				ft::uninitialized_move_if_noexcept(_begin, _end, tmp);
 				for (pointer p = _begin; p != _end; ++p) {
 					_destroy(_alloc, p);
 				}
 				_alloc.deallocate(_begin, _cap);
-				_end = tmp + size();
+				_end = tmp + old_size;
 				_begin = tmp;
 				_cap = new_size;
 			}
@@ -314,12 +457,7 @@ template <class T, class Alloc = std::allocator<T> >
 		template <class InputIterator>
 			void	assign(InputIterator first, InputIterator last,
 				typename ft::enable_if<!ft::is_integral<InputIterator>::value, bool>::type = true) {
-				if (static_cast<size_type>(ft::distance(first, last)) > max_size())
-					throw std::length_error("vector");
-				clear();
-				for (; first != last; ++first) {
-					push_back(*first);
-				}
+				_assign_range(first, last, ft::iterator_category(first));
 			}
 
 		void	assign(size_type n, const value_type& val) {
@@ -344,8 +482,54 @@ template <class T, class Alloc = std::allocator<T> >
 		}
 
 		void	push_back(const value_type& val) {
+# ifdef FT_CXX11
+			emplace_back(val);
+# else
 			_append(1, val);
+# endif
+		}
+
+# ifdef FT_CXX11
+		void	push_back(value_type&& val) {
+			emplace_back(std::move(val));
+		}
+
+		template <class... Args>
+			void	emplace_back(Args&&... args) {
+				if (_end != _begin + _cap) {
+					new (static_cast<void *>(_end)) value_type(std::forward<Args>(args)...);
+					++_end;
+				}
+				else
+					_realloc_emplace(_end, std::forward<Args>(args)...);
+			}
+
+		// args are turned into an element before anything is shifted, so they
+		// may refer to an element of the vector
+		template <class... Args>
+			iterator	emplace(const_iterator position, Args&&... args) {
+				pointer	p = _begin + (position - begin());
+				if (_end == _begin + _cap) {
+					size_type	n = p - _begin;
+					_realloc_emplace(p, std::forward<Args>(args)...);
+					return (iterator(_begin + n));
+				}
+				if (p == _end)
+					new (static_cast<void *>(_end)) value_type(std::forward<Args>(args)...);
+				else {
+					value_type	tmp(std::forward<Args>(args)...);
+					ft::uninitialized_move(_end - 1, _end, _end);
+					ft::move_range_backward(p, _end - 1, _end);
+					*p = std::move(tmp);
+				}
+				++_end;
+				return (iterator(p));
+			}
+
+		iterator	insert(iterator position, value_type&& val) {
+			return (emplace(position, std::move(val)));
 		}
+# endif
 
 		void	pop_back() {
 			if (empty())
@@ -368,80 +552,51 @@ template <class T, class Alloc = std::allocator<T> >
 		void		insert(iterator position, size_type n, const value_type& val) {
 			if (n == 0)
 				return ;
+			pointer	p = position.base();
 			if ((_begin + _cap) - _end >= static_cast<long>(n)) {
-				if (end() - position > static_cast<long>(n)) {
-					ft::uninitialized_copy(end() - n, end(), end());
-					ft::copy_backward(position, end() - n, end());
-					ft::fill(position, position + n, val);
+				// val may be an element that is about to be moved
+				value_type	copy(val);
+				if (_end - p > static_cast<long>(n)) {
+					ft::uninitialized_move(_end - n, _end, _end);
+					ft::move_range_backward(p, _end - n, _end);
+					ft::fill(p, p + n, copy);
 				}
 				else {
-					ft::uninitialized_copy(position, end(), position + n);
-					ft::fill(position, end(), val);
-					ft::uninitialized_fill_n(end(), n - (end() - position), val);
+					ft::uninitialized_move(p, _end, p + n);
+					ft::fill(p, _end, copy);
+					ft::uninitialized_fill_n(_end, n - (_end - p), copy);
 				}
 				_end += n;
 			}
 			else {
-				size_type	len = size() + std::max(size(), n);
+				size_type	old_size = size();
+				size_type	len = old_size + std::max(old_size, n);
 				pointer	tmp = _alloc.allocate(len);
-				ft::uninitialized_copy(begin(), position, tmp);
-				ft::uninitialized_fill_n(tmp + (position - begin()), n, val);
-				ft::uninitialized_copy(position, end(), tmp + (position - begin() + n));
+				ft::uninitialized_fill_n(tmp + (p - _begin), n, val);
+				ft::uninitialized_move_if_noexcept(_begin, p, tmp);
+				ft::uninitialized_move_if_noexcept(p, _end, tmp + (p - _begin + n));
 				for (pointer start = _begin; start != _end; ++start)
 					_destroy(_alloc, start);
 				_alloc.deallocate(_begin, _cap);
 				_cap = len;
-				_end = tmp + size() + n;
+				_end = tmp + old_size + n;
 				_begin = tmp;
 			}
 		}
 		template <class InputIterator>
 			void	insert(iterator position, InputIterator first, InputIterator last,
 				typename ft::enable_if<!ft::is_integral<InputIterator>::value, bool>::type = true) {
-				if (first == last)
-					return;
-				size_type n = 0;
-				n = ft::distance(first, last);
-				if (n > max_size() || size() + n > max_size())
-					throw std::length_error("vector");
-				if ((_begin + _cap) - _end >= static_cast<long>(n)) {
-					ft::copy_backward(position, end(), position + n);
-					ft::copy(first, last, position);
-					_end += n;
-				}
-				else {
-					size_type len = size() + std::max(size(), n);
-					pointer	tmp = _alloc.allocate(len);
-					ft::uninitialized_copy(begin(), position, tmp);
-					ft::uninitialized_copy(first, last, tmp + (position - begin()));
-					ft::uninitialized_copy(position, end(), tmp + (position - begin() + n));
-					for (pointer tmp2 = _begin; tmp2 != _end; ++tmp2)
-						_destroy(_alloc, tmp2);
-					_alloc.deallocate(_begin, _cap);
-					_cap = len;
-					_end = tmp + size() + n;
-					_begin = tmp;
-				}
+				_insert_range(position.base(), first, last, ft::iterator_category(first));
 			}
 		iterator	erase(iterator position) {
 			erase(position, position + 1);
 			return (position);
 		}
 		iterator	erase(iterator first, iterator last) {
-			size_type	first_dst = ft::distance(begin(), first);
-			size_type	last_dst = ft::distance(begin(), last);
-			pointer		first_end = _begin + first_dst;
-
-			for (iterator it = begin() + last_dst; it != end(); ++it) {
-				*first_end = *it;
-				++first_end;
-			}
-			while (last_dst != size()) {
-				_alloc.destroy(_begin + last_dst);
-				last_dst++;
-			}
-			_end = first_end;
-			return (_begin + first_dst);
+			pointer	p = first.base();
+			if (first != last)
+				_destruct_at_end(ft::move_range(last.base(), _end, p));
+			return (iterator(p));
 		}
 
 		void		swap(vector& x) {
@@ -508,6 +663,10 @@ template <class T, class Alloc = std::allocator<T> >
 			x.swap(y);
 		}
 
+	// an empty vector owns no memory, so a vector of vectors grows by swapping
+	template <class T>
+		struct has_cheap_swap<vector<T, std::allocator<T> > > : public true_type { };
+
 	template <class T, class Alloc>
 	std::ostream	&operator<<(std::ostream &o, const vector<T, Alloc> &v) {
 		for (typename vector<T, Alloc>::const_iterator it = v.begin(); it != v.end(); ++it) {